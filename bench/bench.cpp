@@ -0,0 +1,465 @@
+#include "utils.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <latch>
+#include <thread>
+#include <vector>
+
+namespace un::event::bench {
+    using clock = std::chrono::steady_clock;
+    using namespace std::chrono_literals;
+
+    static double ns_between(clock::time_point a, clock::time_point b) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+    }
+
+    // `producers` threads each post `per_producer` empty jobs; measures until the loop has run all of them
+    static void call_soon_throughput(reporter& r, int producers, int per_producer) {
+        auto loop = bench_loop::make();
+        const int64_t total = int64_t{producers} * per_producer;
+
+        int64_t ran{0};
+        std::promise<clock::time_point> done;
+        auto fut = done.get_future();
+        std::latch start{producers + 1};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                start.arrive_and_wait();
+                for (int i = 0; i < per_producer; ++i) {
+                    loop->call_soon([&] {
+                        if (++ran == total)
+                            done.set_value(clock::now());
+                    });
+                }
+            });
+        }
+
+        // producers cannot start before this thread arrives, so take the start time first
+        auto t0 = clock::now();
+        start.arrive_and_wait();
+        auto t1 = fut.get();
+
+        for (auto& t : threads)
+            t.join();
+
+        auto ns = ns_between(t0, t1);
+        r.add({.name = "call_soon_throughput",
+               .params = {{"producers", producers}, {"jobs", static_cast<double>(total)}},
+               .metrics = {{"ops_per_sec", total / (ns / 1e9)}, {"ns_per_op", ns / total}}});
+    }
+
+    static void call_get_latency(reporter& r, int rounds) {
+        auto loop = bench_loop::make();
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(rounds);
+
+        for (int i = 0; i < rounds; ++i) {
+            auto t0 = clock::now();
+            loop->call_get([] {});
+            samples.push_back(clock::now() - t0);
+        }
+
+        r.add("call_get_round_trip", {{"rounds", rounds}}, summarize(std::move(samples)));
+    }
+
+    // Posts into an idle loop and measures until the job starts running on the loop thread
+    static void wakeup_latency(reporter& r, const loop_options& opts, double spin_us, int rounds) {
+        auto loop = bench_loop::make(opts);
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(rounds);
+
+        for (int i = 0; i < rounds; ++i) {
+            // give a non-spinning loop time to block again
+            std::this_thread::sleep_for(50us);
+
+            std::promise<clock::time_point> p;
+            auto fut = p.get_future();
+            auto t0 = clock::now();
+            loop->call_soon([&] { p.set_value(clock::now()); });
+            samples.push_back(fut.get() - t0);
+        }
+
+        r.add("wakeup_latency", {{"spin_budget_us", spin_us}, {"rounds", rounds}}, summarize(std::move(samples)));
+    }
+
+    // Bounces a job between two loops, timing each round trip as seen from loop `a`
+    static void ping_pong(reporter& r, const loop_options& opts, double spin_us, int rounds) {
+        auto a = bench_loop::make(opts);
+        auto b = bench_loop::make(opts);
+
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(rounds);
+
+        std::promise<void> done;
+        auto fut = done.get_future();
+
+        std::function<void()> ping;
+        ping = [&] {
+            auto start = clock::now();
+            b->call_soon([&, start] {
+                a->call_soon([&, start] {
+                    samples.push_back(clock::now() - start);
+                    if (static_cast<int>(samples.size()) == rounds)
+                        done.set_value();
+                    else
+                        ping();
+                });
+            });
+        };
+
+        a->call_soon([&] { ping(); });
+        fut.wait();
+
+        r.add("ping_pong", {{"spin_budget_us", spin_us}, {"rounds", rounds}}, summarize(std::move(samples)));
+    }
+
+    // Inserts `count` one-shot timers from the loop thread and measures insertion and firing
+    static void timer_insert_fire(reporter& r, int count) {
+        auto loop = bench_loop::make();
+        constexpr auto delay = 1ms;
+
+        int fired{0};
+        std::promise<clock::time_point> done;
+        auto fut = done.get_future();
+
+        clock::time_point t0, t1;
+        loop->call_get([&] {
+            t0 = clock::now();
+            for (int i = 0; i < count; ++i) {
+                loop->call_later(delay, [&] {
+                    if (++fired == count)
+                        done.set_value(clock::now());
+                });
+            }
+            t1 = clock::now();
+        });
+
+        auto t2 = fut.get();
+        auto fire_start = std::max(t1, t0 + delay);
+
+        r.add({.name = "call_later_insert",
+               .params = {{"timers", count}},
+               .metrics = {{"ns_per_op", ns_between(t0, t1) / count}}});
+        r.add({.name = "call_later_fire",
+               .params = {{"timers", count}},
+               .metrics = {{"ns_per_op", ns_between(fire_start, t2) / count}}});
+    }
+
+    // Starts `count` long-interval tickers, then measures stopping (cancelling) each of them
+    static void ticker_start_cancel(reporter& r, int count) {
+        auto loop = bench_loop::make();
+
+        loop->call_get([&] {
+            std::vector<std::shared_ptr<bench_loop::ev_watcher>> watchers;
+            watchers.reserve(count);
+
+            auto t0 = clock::now();
+            for (int i = 0; i < count; ++i)
+                watchers.push_back(loop->call_every(1h, [] {}));
+            auto t1 = clock::now();
+            for (auto& w : watchers)
+                w->stop();
+            auto t2 = clock::now();
+            watchers.clear();
+            auto t3 = clock::now();
+
+            r.add({.name = "call_every_start",
+                   .params = {{"timers", count}},
+                   .metrics = {{"ns_per_op", ns_between(t0, t1) / count}}});
+            r.add({.name = "call_every_cancel",
+                   .params = {{"timers", count}},
+                   .metrics = {{"ns_per_op", ns_between(t1, t2) / count}}});
+            r.add({.name = "call_every_destroy",
+                   .params = {{"timers", count}},
+                   .metrics = {{"ns_per_op", ns_between(t2, t3) / count}}});
+        });
+    }
+
+    // Cost of a make_shared object whose last reference is dropped off, and on, the loop thread: an
+    // allocation from the loop's object pool and its return, with the destructor run on the loop
+    static void pool_release(reporter& r, int count) {
+        auto loop = bench_loop::make();
+
+        auto t0 = clock::now();
+        for (int i = 0; i < count; ++i) {
+            auto p = loop->make_shared<int>(i);
+            p.reset();
+        }
+        auto t1 = clock::now();
+
+        r.add({.name = "pool_release_remote",
+               .params = {{"objects", count}},
+               .metrics = {{"ns_per_op", ns_between(t0, t1) / count}}});
+
+        loop->call_get([&] {
+            auto t0 = clock::now();
+            for (int i = 0; i < count; ++i) {
+                auto p = loop->make_shared<int>(i);
+                p.reset();
+            }
+            auto t1 = clock::now();
+
+            r.add({.name = "pool_release_local",
+                   .params = {{"objects", count}},
+                   .metrics = {{"ns_per_op", ns_between(t0, t1) / count}}});
+        });
+    }
+
+    // Blocking keep-alive client: `rounds` batches of `depth` pipelined GETs, timing each batch
+    static std::vector<std::chrono::nanoseconds> http_client(uint16_t port, int depth, int rounds) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in sin{};
+        sin.sin_family = AF_INET;
+        sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        sin.sin_port = htons(port);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) != 0) {
+            std::perror("connect");
+            std::exit(1);
+        }
+
+        constexpr std::string_view request{"GET /ping HTTP/1.1\r\nHost: bench\r\n\r\n"};
+        std::string batch;
+        for (int i = 0; i < depth; ++i)
+            batch += request;
+
+        char buf[65536];
+        auto exchange = [&](std::string_view out, size_t expect) {
+            while (not out.empty()) {
+                auto n = ::write(fd, out.data(), out.size());
+                if (n < 0 and errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    std::perror("write");
+                    std::exit(1);
+                }
+                out.remove_prefix(static_cast<size_t>(n));
+            }
+            size_t got{0};
+            std::string first;
+            while (expect ? got < expect : not first.ends_with("pong")) {
+                auto n = ::read(fd, buf, sizeof(buf));
+                if (n <= 0) {
+                    std::perror("read");
+                    std::exit(1);
+                }
+                got += n;
+                if (not expect)
+                    first.append(buf, n);
+            }
+            return got;
+        };
+
+        // every response is the same size (the Date header is fixed width), so learn it once
+        auto response_size = exchange(request, 0);
+
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(rounds);
+        for (int i = 0; i < rounds; ++i) {
+            auto t0 = clock::now();
+            exchange(batch, response_size * depth);
+            samples.push_back(clock::now() - t0);
+        }
+
+        ::close(fd);
+        return samples;
+    }
+
+    // `clients` connections hammer a server sharded over `loops` loops with pipelined requests
+    static void http_loopback(reporter& r, int loops, int clients, int depth, int rounds) {
+        loop_pool<bench_channel> pool{static_cast<size_t>(loops)};
+        static constexpr std::string_view pong{"pong"};
+
+        auto servers = pool.serve_http({}, [](bench_loop::http_server& s) {
+            s.route("/ping", [](http_request req) { req.reply_ref(HTTP_OK, pong); });
+        });
+        auto port = servers.front()->port();
+
+        std::vector<std::future<std::vector<std::chrono::nanoseconds>>> results;
+        auto t0 = clock::now();
+        for (int c = 0; c < clients; ++c)
+            results.push_back(std::async(std::launch::async, http_client, port, depth, rounds));
+
+        std::vector<std::chrono::nanoseconds> samples;
+        for (auto& f : results) {
+            auto s = f.get();
+            samples.insert(samples.end(), s.begin(), s.end());
+        }
+        auto ns = ns_between(t0, clock::now());
+
+        const double total = static_cast<double>(clients) * depth * rounds;
+        r.add({.name = "http_loopback_throughput",
+               .params = {{"loops", loops}, {"clients", clients}, {"depth", depth}},
+               .metrics = {{"requests_per_sec", total / (ns / 1e9)}}});
+        r.add("http_loopback_batch_latency",
+              {{"loops", loops}, {"clients", clients}, {"depth", depth}},
+              summarize(std::move(samples)));
+    }
+
+    // A writer thread streams `count` messages of `size` bytes through a shared memory ring to a loop
+    static void shm_stream(reporter& r, int count, int size) {
+        int sv[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0)
+            return;
+        auto ch = shm_channel::create(1 << 20);
+        ch.send_to(sv[0]);
+        auto writer = shm_channel::receive(sv[1]);
+        ::close(sv[0]);
+        ::close(sv[1]);
+
+        auto loop = bench_loop::make();
+        int received{0};
+        std::promise<clock::time_point> done;
+        auto fut = done.get_future();
+        auto reader = loop->make_shm_reader(std::move(ch), [&](std::string_view) {
+            if (++received == count)
+                done.set_value(clock::now());
+        });
+
+        const std::string msg(size, 'x');
+        auto t0 = clock::now();
+        std::thread t{[&] {
+            for (int i = 0; i < count; ++i) {
+                while (not writer.try_send(msg))
+                    std::this_thread::yield();
+            }
+        }};
+        auto t1 = fut.get();
+        t.join();
+
+        auto ns = ns_between(t0, t1);
+        r.add({.name = "shm_stream",
+               .params = {{"messages", count}, {"size", size}},
+               .metrics = {{"messages_per_sec", count / (ns / 1e9)},
+                           {"ns_per_message", ns / count},
+                           {"wakeups_per_message", static_cast<double>(writer.notifications()) / count}}});
+
+        reader.reset();
+    }
+
+    struct config {
+        std::string json_path{};
+        std::string filter{};
+        int max_producers{static_cast<int>(std::max(4U, std::thread::hardware_concurrency()))};
+        int max_timers{1'000'000};
+        int spin_us{50};
+        bool quick{false};
+    };
+
+    static int parse_int(std::string_view s, int def) {
+        int v = def;
+        std::from_chars(s.data(), s.data() + s.size(), v);
+        return v;
+    }
+
+    static config parse_args(int argc, char** argv) {
+        config c;
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg{argv[i]};
+            auto value = [&]() -> std::string_view { return i + 1 < argc ? argv[++i] : ""; };
+
+            if (arg == "--json")
+                c.json_path = value();
+            else if (arg == "--filter")
+                c.filter = value();
+            else if (arg == "--producers")
+                c.max_producers = parse_int(value(), c.max_producers);
+            else if (arg == "--max-timers")
+                c.max_timers = parse_int(value(), c.max_timers);
+            else if (arg == "--spin-us")
+                c.spin_us = parse_int(value(), c.spin_us);
+            else if (arg == "--quick")
+                c.quick = true;
+            else {
+                std::fprintf(
+                        stderr,
+                        "usage: %s [--json FILE] [--filter SUBSTR] [--producers N] [--max-timers N] [--spin-us N] "
+                        "[--quick]\n",
+                        argv[0]);
+                std::exit(arg == "--help" ? 0 : 1);
+            }
+        }
+
+        if (c.quick)
+            c.max_timers = std::min(c.max_timers, 10'000);
+
+        return c;
+    }
+}  // namespace un::event::bench
+
+int main(int argc, char** argv) {
+    using namespace un::event;
+    using namespace un::event::bench;
+
+    auto cfg = parse_args(argc, argv);
+    reporter r{cfg.filter};
+
+    const int scale = cfg.quick ? 10 : 1;
+
+    if (r.enabled("call_soon_throughput")) {
+        for (int p = 1; p <= cfg.max_producers; p *= 2)
+            call_soon_throughput(r, p, 200'000 / scale);
+    }
+
+    if (r.enabled("call_get_round_trip"))
+        call_get_latency(r, 20'000 / scale);
+
+    loop_options blocking{};
+    loop_options spinning{};
+    spinning.spin_budget = std::chrono::microseconds{cfg.spin_us};
+
+    if (r.enabled("wakeup_latency")) {
+        wakeup_latency(r, blocking, 0, 5'000 / scale);
+        wakeup_latency(r, spinning, cfg.spin_us, 5'000 / scale);
+    }
+
+    if (r.enabled("ping_pong")) {
+        ping_pong(r, blocking, 0, 50'000 / scale);
+        ping_pong(r, spinning, cfg.spin_us, 50'000 / scale);
+    }
+
+    for (int n = 1'000; n <= cfg.max_timers; n *= 10) {
+        if (r.enabled("call_later"))
+            timer_insert_fire(r, n);
+        if (r.enabled("call_every"))
+            ticker_start_cancel(r, n);
+    }
+
+    if (r.enabled("pool_release"))
+        pool_release(r, 100'000 / scale);
+
+    if (r.enabled("http_loopback")) {
+        for (int loops : {1, 2}) {
+            for (int depth : {1, 16})
+                http_loopback(r, loops, 4, depth, 20'000 / scale / depth);
+        }
+    }
+
+    if (r.enabled("shm_stream")) {
+        for (int size : {64, 1024})
+            shm_stream(r, 1'000'000 / scale, size);
+    }
+
+    auto json = r.to_json();
+    if (cfg.json_path.empty()) {
+        std::fputs(json.c_str(), stdout);
+    }
+    else {
+        std::ofstream{cfg.json_path} << json;
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+namespace un::event::bench {
+
+    channel_type bench_channel = [] {
+        auto channel = bench_log::make_channel(channel_config::make("unevent-bench"));
+        bench_log::start();
+        return channel;
+    }();
+
+    latency_stats summarize(std::vector<std::chrono::nanoseconds> samples) {
+        latency_stats s{.samples = samples.size()};
+        if (samples.empty()) {
+            return s;
+        }
+
+        std::ranges::sort(samples);
+        auto at = [&](double p) {
+            return static_cast<double>(
+                    samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))].count());
+        };
+
+        auto total = std::accumulate(samples.begin(), samples.end(), std::chrono::nanoseconds{0});
+
+        s.min_ns = static_cast<double>(samples.front().count());
+        s.mean_ns = static_cast<double>(total.count()) / samples.size();
+        s.p50_ns = at(0.50);
+        s.p90_ns = at(0.90);
+        s.p99_ns = at(0.99);
+        s.p999_ns = at(0.999);
+        s.max_ns = static_cast<double>(samples.back().count());
+        return s;
+    }
+
+    void reporter::add(result r) {
+        std::string line = r.name;
+        for (const auto& [k, v] : r.params) {
+            line += " " + k + "=" + std::to_string(static_cast<long long>(v));
+        }
+        line += " :";
+        for (const auto& [k, v] : r.metrics) {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), " %s=%.1f", k.c_str(), v);
+            line += buf;
+        }
+        std::fprintf(stderr, "%s\n", line.c_str());
+
+        results.push_back(std::move(r));
+    }
+
+    void reporter::add(std::string name, std::map<std::string, double> params, const latency_stats& s) {
+        add(result{
+                .name = std::move(name),
+                .params = std::move(params),
+                .metrics = {
+                        {"samples", static_cast<double>(s.samples)},
+                        {"min_ns", s.min_ns},
+                        {"mean_ns", s.mean_ns},
+                        {"p50_ns", s.p50_ns},
+                        {"p90_ns", s.p90_ns},
+                        {"p99_ns", s.p99_ns},
+                        {"p999_ns", s.p999_ns},
+                        {"max_ns", s.max_ns}}});
+    }
+
+    static void append_object(std::string& out, const std::map<std::string, double>& m) {
+        out += '{';
+        bool first = true;
+        for (const auto& [k, v] : m) {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "%.3f", v);
+            out += (first ? "\"" : ",\"") + k + "\":" + buf;
+            first = false;
+        }
+        out += '}';
+    }
+
+    std::string reporter::to_json() const {
+        std::string out{"{\"suite\":\"unevent\",\"benchmarks\":["};
+        bool first = true;
+        for (const auto& r : results) {
+            out += (first ? "{\"name\":\"" : ",{\"name\":\"") + r.name + "\",\"params\":";
+            append_object(out, r.params);
+            out += ",\"metrics\":";
+            append_object(out, r.metrics);
+            out += '}';
+            first = false;
+        }
+        out += "]}\n";
+        return out;
+    }
+}  // namespace un::event::bench
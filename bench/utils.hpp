@@ -0,0 +1,55 @@
+#pragma once
+
+#include <uneventful.hpp>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace un::event::bench {
+    using bench_log = unlog::configured<unlog::default_global_config>;
+    using channel_config = unlog::config<unlog::options::threadsafe>;
+    using channel_policy = unlog::detail::channel_policy_for<channel_config>;
+    using channel_type = unlog::channel<bench_log::config, channel_policy>;
+
+    extern channel_type bench_channel;
+    using bench_loop = unevent_loop<bench_channel>;
+
+    struct latency_stats {
+        size_t samples{0};
+        double min_ns{0};
+        double mean_ns{0};
+        double p50_ns{0};
+        double p90_ns{0};
+        double p99_ns{0};
+        double p999_ns{0};
+        double max_ns{0};
+    };
+
+    latency_stats summarize(std::vector<std::chrono::nanoseconds> samples);
+
+    struct result {
+        std::string name;
+        std::map<std::string, double> params;
+        std::map<std::string, double> metrics;
+    };
+
+    // Collects results, echoes them in human-readable form and serializes them as JSON
+    class reporter {
+        std::vector<result> results;
+        std::string filter;
+
+      public:
+        explicit reporter(std::string _filter = {}) : filter{std::move(_filter)} {}
+
+        // Whether a benchmark named `name` passes the --filter substring
+        bool enabled(std::string_view name) const { return filter.empty() or name.find(filter) != name.npos; }
+
+        void add(result r);
+        void add(std::string name, std::map<std::string, double> params, const latency_stats& s);
+
+        std::string to_json() const;
+    };
+}  // namespace un::event::bench
@@ -1,3 +1,14 @@
 #pragma once
 
+#include "uneventful/connect.hpp"
+#include "uneventful/connection_pool.hpp"
+#include "uneventful/dns.hpp"
+#include "uneventful/execution.hpp"
+#include "uneventful/http.hpp"
 #include "uneventful/loop.hpp"
+#include "uneventful/loop_pool.hpp"
+#include "uneventful/parallel.hpp"
+#include "uneventful/rate_limit.hpp"
+#include "uneventful/shm.hpp"
+#include "uneventful/signal.hpp"
+#include "uneventful/stream.hpp"
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace un::event {
+    // What `unevent_loop::call_blocking` hands back: the work's result, or the exception it threw
+    template <typename T>
+    using blocking_result = std::expected<T, std::exception_ptr>;
+
+    struct file_write_options {
+        bool append{false};  // append instead of truncating
+        bool sync{false};    // fsync before completing
+    };
+
+    /** Bounded set of helper threads for work that would otherwise block a loop thread (file I/O,
+        fsync, getpwnam, compression of large buffers...). Threads are started on demand, up to
+        `max_threads`, as queued tasks outnumber idle threads, and live until the pool is destroyed.
+        The queue itself is unbounded so that submitting never blocks the caller.
+
+        Loops submit through `unevent_loop::call_blocking`, which hands results back to the loop;
+        `submit` is the raw interface. The destructor finishes every queued task before joining;
+        run from one of the pool's own tasks, it detaches that thread instead of joining it.
+     */
+    class blocking_pool {
+      public:
+        using task = std::move_only_function<void()>;
+
+        explicit blocking_pool(size_t max_threads = 4);
+        ~blocking_pool();
+
+        blocking_pool(const blocking_pool&) = delete;
+        blocking_pool& operator=(const blocking_pool&) = delete;
+
+        void submit(task t);
+
+        size_t max_threads() const noexcept { return max_size; }
+
+        // Number of helper threads started so far
+        size_t threads() const;
+
+        // Process-wide pool used by loops whose options name none; sized from the cpu count
+        static blocking_pool& shared();
+
+      private:
+        const size_t max_size;
+
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<task> tasks;
+        std::vector<std::thread> workers;
+        size_t idle{0};
+        bool stopping{false};
+
+        void work();
+    };
+
+    namespace detail {
+        // Blocking helpers behind `unevent_loop::read_file`/`write_file`; throw std::system_error
+        std::string read_whole_file(const std::filesystem::path& path);
+        void write_whole_file(const std::filesystem::path& path, std::string_view data, bool append, bool sync);
+    }  // namespace detail
+}  // namespace un::event
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <event2/event.h>
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+namespace un::event {
+    enum class channel_mode : uint8_t {
+        spsc,  // exactly one producing thread at a time
+        mpsc,  // any number of concurrent producers
+    };
+
+    /** Bounded, typed message channel into a consumer loop. Messages are constructed directly in a
+        fixed ring of slots (no per-message allocation or type erasure) and handed to the consumer's
+        handler in place, on the consumer loop thread.
+
+        Producers never take a lock. The consumer is woken at most once per batch: only the send
+        that finds the channel un-notified activates its event, and every message that arrives
+        before the consumer gets to run rides the same wakeup. Each wakeup drains up to one ring's
+        worth of messages before yielding back to the loop.
+
+        The ring is a sequence-numbered array (one atomic sequence word per slot); in mpsc mode
+        producers claim slots with a CAS on the tail, in spsc mode with a plain store.
+
+        The channel does not keep its consumer loop alive. Producers may outlive that loop; once it
+        is gone nothing is woken, and messages stay in the ring until the channel is destroyed.
+     */
+    template <typename T, typename Loop, channel_mode Mode = channel_mode::mpsc>
+    class channel {
+        struct cell {
+            std::atomic<size_t> seq;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T* get() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        const size_t mask;
+        std::unique_ptr<cell[]> cells;
+
+        // producer and consumer indices on separate cache lines
+        alignas(64) std::atomic<size_t> tail{0};
+        alignas(64) size_t head{0};
+        // read by every send, so kept off the consumer's line; only written once per batch
+        alignas(64) std::atomic<bool> notified{false};
+
+        std::weak_ptr<Loop> loop;
+        std::function<void(T&&)> handler;
+        std::unique_ptr<::event, void (*)(::event*)> ev;
+
+        static void drain_cb(evutil_socket_t, short, void* arg) { static_cast<channel*>(arg)->drain(); }
+
+      public:
+        using value_type = T;
+
+        // `capacity` is rounded up to a power of two
+        channel(Loop& l, size_t capacity, std::function<void(T&&)> f) :
+                mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1},
+                cells{new cell[mask + 1]},
+                loop{l.weak_from_this()},
+                handler{std::move(f)},
+                ev{event_new(l.loop(), -1, 0, &channel::drain_cb, this), ::event_free} {
+            if (not ev) {
+                throw std::runtime_error{"Failed to create channel event"};
+            }
+            for (size_t i = 0; i <= mask; ++i) {
+                cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        channel(const channel&) = delete;
+        channel& operator=(const channel&) = delete;
+
+        ~channel() {
+            detail::release_on_loop(loop, [this] { ev.reset(); }, [this] { (void)ev.release(); });
+
+            // messages sent after the last drain are destroyed unhandled
+            for (;;) {
+                auto& c = cells[head & mask];
+                if (c.seq.load(std::memory_order_acquire) != head + 1) {
+                    break;
+                }
+                std::destroy_at(c.get());
+                ++head;
+            }
+        }
+
+        size_t capacity() const noexcept { return mask + 1; }
+
+        // Constructs a message in place; returns false without constructing if the ring is full
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            auto pos = tail.load(std::memory_order_relaxed);
+            cell* c;
+
+            for (;;) {
+                c = &cells[pos & mask];
+                auto seq = c->seq.load(std::memory_order_acquire);
+                auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                if (dif < 0) {
+                    return false;
+                }
+                if (dif == 0) {
+                    if constexpr (Mode == channel_mode::spsc) {
+                        tail.store(pos + 1, std::memory_order_relaxed);
+                        break;
+                    }
+                    else if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::construct_at(c->get(), std::forward<Args>(args)...);
+            c->seq.store(pos + 1, std::memory_order_release);
+
+            // one wakeup per batch. The fence pairs with the one in drain(): either this load sees
+            // the consumer's reset, or the consumer sees the message just published. Producers that
+            // find the channel already notified then leave its cache line shared instead of each
+            // taking it exclusive for an exchange.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (not notified.load(std::memory_order_relaxed) and
+                not notified.exchange(true, std::memory_order_acq_rel)) {
+                // held for the call, so that the loop cannot free the event's base under it
+                if (auto l = loop.lock()) {
+                    event_active(ev.get(), 0, 0);
+                }
+            }
+
+            return true;
+        }
+
+        bool try_send(T msg) { return try_emplace(std::move(msg)); }
+
+      private:
+        void drain() {
+            notified.exchange(false, std::memory_order_acq_rel);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            for (size_t n = 0; n <= mask; ++n) {
+                auto& c = cells[head & mask];
+                if (c.seq.load(std::memory_order_acquire) != head + 1) {
+                    return;
+                }
+
+                auto* msg = c.get();
+                try {
+                    handler(std::move(*msg));
+                } catch (const std::exception& e) {
+                    unlog::critical(Loop::log, "Channel handler caught exception: {}", e.what());
+                }
+                std::destroy_at(msg);
+
+                c.seq.store(head + mask + 1, std::memory_order_release);
+                ++head;
+            }
+
+            // a full ring's worth handled; yield to the loop and continue on the next pass
+            if (not notified.exchange(true, std::memory_order_acq_rel)) {
+                event_active(ev.get(), 0, 0);
+            }
+        }
+    };
+}  // namespace un::event
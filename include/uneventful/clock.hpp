@@ -0,0 +1,88 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace un::event {
+    /** Virtual time for a loop's timers, advanced only by hand. A loop created with a manual clock
+        in its `loop_options` keeps its `call_later`, `call_every`, `call_every_fixed` and ticker
+        group timers off libevent's heap: they fire exclusively from `advance`, in deadline order
+        (ties in the order they were scheduled), each seeing `now()` equal to its own deadline. A
+        test or benchmark with a million timers spread over an hour runs in the time it takes to
+        call them, and runs the same way every time.
+
+        Only those timers follow the clock. I/O, libevent timers used directly (`schedule_after`,
+        connect timeouts, rate limits) and callback timing for metrics and the slow-callback
+        watchdog stay on real time.
+
+        A clock drives at most one loop. It starts at an arbitrary fixed point, so that runs are
+        reproducible, and only moves forward.
+     */
+    class manual_clock {
+      public:
+        using time_point = std::chrono::steady_clock::time_point;
+        using duration = std::chrono::steady_clock::duration;
+
+      private:
+        std::atomic<time_point> current;
+        // the loop thread while it fires timers, which must not advance the clock themselves
+        std::atomic<std::thread::id> firing{};
+        // held across a whole advance
+        std::mutex mutex;
+        std::function<void(time_point)> driver;
+
+        template <auto&>
+        friend class unevent_loop;
+
+        // Called by the loop as it fires each timer
+        void set(time_point t) noexcept { current.store(t, std::memory_order_release); }
+
+        void attach(std::function<void(time_point)> run_until) {
+            std::lock_guard lock{mutex};
+            if (driver) {
+                throw std::logic_error{"manual_clock already drives a loop"};
+            }
+            driver = std::move(run_until);
+        }
+
+        // Waits for an advance in progress
+        void detach() {
+            std::lock_guard lock{mutex};
+            driver = nullptr;
+        }
+
+      public:
+        explicit manual_clock(time_point start = time_point{24h}) : current{start} {}
+
+        manual_clock(const manual_clock&) = delete;
+        manual_clock& operator=(const manual_clock&) = delete;
+
+        time_point now() const noexcept { return current.load(std::memory_order_acquire); }
+
+        /** Moves time forward to `t`, first firing every timer due by then on the loop thread; returns
+            once they have all run. Timers due at the current time fire too, so `advance(0s)` runs
+            those. Jobs that the timers queue run after `advance` returns; a `call_get` waits for them.
+            Moving backwards is ignored. Must not be called from a timer callback.
+         */
+        void advance_to(time_point t) {
+            if (firing.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+                throw std::logic_error{"manual_clock cannot be advanced from a timer it fired"};
+            }
+
+            std::lock_guard lock{mutex};
+            t = std::max(t, now());
+            if (driver) {
+                driver(t);
+            }
+            set(t);
+        }
+
+        void advance(duration d) { advance_to(now() + d); }
+    };
+}  // namespace un::event
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <event2/event.h>
+#include <event2/util.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace un::event {
+    // One resolved socket address, as handed to `tcp_connect`
+    struct sock_address {
+        sockaddr_storage addr{};
+        socklen_t len{0};
+
+        int family() const noexcept { return addr.ss_family; }
+    };
+
+    /** Resolves a numeric `host` (IPv4 or IPv6 literal) and `port` without touching the network or
+        blocking; returns an empty list if `host` is a name that needs a lookup.
+     */
+    std::vector<sock_address> numeric_addresses(const std::string& host, uint16_t port);
+
+    // Blocking getaddrinfo lookup of `host`; throws std::system_error if it fails
+    std::vector<sock_address> resolve_addresses(const std::string& host, uint16_t port);
+
+    struct connect_options {
+        // head start given to each attempt before racing the next address (RFC 8305 recommends 250ms)
+        std::chrono::milliseconds attempt_delay{250ms};
+        // gives up on the whole connect, every attempt included, after this long
+        std::chrono::milliseconds timeout{10s};
+    };
+
+    /** Non-blocking TCP connect racing a host's addresses ("happy eyeballs", RFC 8305). Addresses
+        are interleaved by family, starting with the family listed first, and tried in turn: each
+        attempt gets `attempt_delay` to itself before the next one starts alongside it, and a failed
+        attempt starts the next at once. The first connection to complete wins and the others are
+        abandoned, so an unreachable IPv6 route costs one attempt delay rather than a full timeout.
+
+        The connect keeps itself alive until it completes; the returned handle is only needed to
+        `cancel()`. Must be used on the loop thread of `base`.
+     */
+    class tcp_connect {
+      public:
+        // Called once with the outcome and, on success, the connected non-blocking socket
+        using completion = std::move_only_function<void(std::error_code, evutil_socket_t)>;
+
+        // Throws std::invalid_argument if `addrs` is empty, std::runtime_error if events cannot be created
+        static std::shared_ptr<tcp_connect> start(
+                event_base* base, std::vector<sock_address> addrs, completion done, const connect_options& opts = {});
+
+        ~tcp_connect();
+
+        tcp_connect(const tcp_connect&) = delete;
+        tcp_connect& operator=(const tcp_connect&) = delete;
+
+        bool finished() const noexcept { return not self; }
+
+        // Abandons every attempt; `done` receives std::errc::operation_canceled
+        void cancel();
+
+      private:
+        struct attempt {
+            evutil_socket_t fd;
+            std::unique_ptr<::event, void (*)(::event*)> ev{nullptr, ::event_free};
+        };
+
+        tcp_connect(std::vector<sock_address> addrs, completion done, const connect_options& opts);
+
+        static void on_writable(evutil_socket_t fd, short, void* arg);
+        static void on_next(evutil_socket_t, short, void* arg);
+        static void on_timeout(evutil_socket_t, short, void* arg);
+
+        // Starts attempts until one is in flight or the addresses run out
+        void launch();
+        void drop(evutil_socket_t fd);
+        void finish(std::error_code ec, evutil_socket_t fd = -1);
+
+        event_base* base{nullptr};
+        std::vector<sock_address> addrs;
+        size_t next{0};
+        std::vector<attempt> attempts;
+        std::error_code last_error{std::make_error_code(std::errc::host_unreachable)};
+
+        const std::chrono::milliseconds attempt_delay;
+        const std::chrono::milliseconds timeout;
+
+        std::unique_ptr<::event, void (*)(::event*)> next_ev{nullptr, ::event_free};
+        std::unique_ptr<::event, void (*)(::event*)> timeout_ev{nullptr, ::event_free};
+        // held while running, so that the connect outlives every handle the caller drops
+        std::shared_ptr<tcp_connect> self;
+
+        completion done;
+    };
+}  // namespace un::event
@@ -0,0 +1,459 @@
+#pragma once
+
+#include "blocking.hpp"
+#include "connect.hpp"
+#include "dns.hpp"
+#include "utils.hpp"
+
+#include <event2/buffer.h>
+
+#include <chrono>
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <map>
+#include <memory>
+#include <source_location>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace un::event {
+    // Where a pooled connection goes: a host name or numeric address, and a TCP port
+    struct endpoint {
+        std::string host;
+        uint16_t port{0};
+
+        auto operator<=>(const endpoint&) const = default;
+    };
+
+    struct connection_pool_options {
+        // connections per endpoint, whether leased, idle or still connecting; acquires beyond it wait
+        size_t max_per_endpoint{32};
+        // idle connections kept per endpoint; connections released beyond it are closed
+        size_t max_idle_per_endpoint{8};
+        // an idle connection unused for this long is closed on the next sweep
+        std::chrono::milliseconds idle_timeout{60s};
+        // cadence of the idle sweep, when the pool makes its own ticker group
+        std::chrono::milliseconds sweep_interval{1s};
+        connect_options connect{};
+    };
+
+    struct connection_pool_stats {
+        size_t connects{0};  // connections established
+        size_t reuses{0};    // acquires served by a connection that had been released before
+        size_t open{0};      // leased, idle and connecting, across every endpoint
+        size_t idle{0};
+        size_t waiting{0};   // acquires waiting for an endpoint under its cap
+    };
+
+    /** Outbound connections kept per endpoint for reuse. `acquire` hands out the most recently
+        released idle connection to the endpoint if there is one, otherwise opens a new one (racing
+        the endpoint's addresses with `tcp_connect`) as long as the endpoint is under
+        `max_per_endpoint`, and otherwise waits for a connection to come back. A released connection
+        goes straight to the next waiter, or is kept idle if it is still open with nothing buffered
+        in either direction.
+
+        Idle connections are closed by a sweep riding a ticker group (see `unevent_loop::
+        make_ticker_group`), which may be shared with other pools and tickers at the same cadence;
+        an idle connection that the peer closes or that receives unsolicited data is closed on the
+        spot and dropped at the next acquire or sweep.
+
+        Names that are not numeric addresses are resolved by the pool's `dns_resolver` (which must
+        belong to the same loop) if it was given one, and otherwise with getaddrinfo on the loop's
+        blocking pool, on every new connection.
+
+        Created with `unevent_loop::make_connection_pool`; the pool is only touched on its loop's
+        thread, and `acquire` and leases hop there from anywhere else. The pool does not keep its
+        loop alive: once the loop is gone, acquires fail with operation_canceled and released
+        connections are closed.
+     */
+    template <typename Loop>
+    class connection_pool {
+        using stream = typename Loop::stream;
+        using stream_ptr = std::shared_ptr<stream>;
+
+        struct idle_conn {
+            stream_ptr s;
+            std::chrono::steady_clock::time_point since;
+        };
+
+      public:
+        class lease;
+        using callback = std::function<void(std::expected<lease, std::error_code>)>;
+
+      private:
+        struct host_state {
+            endpoint ep;
+            // most recently released at the back
+            std::deque<idle_conn> idle;
+            std::deque<callback> waiters;
+            std::vector<std::shared_ptr<tcp_connect>> connecting;
+            size_t open{0};
+
+            explicit host_state(endpoint e) : ep{std::move(e)} {}
+        };
+
+      public:
+        /** Exclusive use of a pooled connection. Destroying (or resetting) the lease gives the
+            connection back to the pool from a queued job, so it may be dropped from inside the
+            stream's own callbacks; `discard` closes it instead. The stream's `on_data`/`on_close`
+            callbacks are cleared on hand-out, so data that arrived before the new owner set them is
+            waiting in `input()`.
+         */
+        class lease {
+            friend class connection_pool;
+
+            std::weak_ptr<connection_pool> pool;
+            host_state* host{nullptr};
+            stream_ptr conn;
+
+            lease(std::weak_ptr<connection_pool> p, host_state* h, stream_ptr s) :
+                    pool{std::move(p)}, host{h}, conn{std::move(s)} {}
+
+            void give_back(bool reusable) {
+                if (not conn) {
+                    return;
+                }
+                auto p = pool.lock();
+                if (auto l = p ? p->loop.lock() : nullptr) {
+                    l->call_soon([p, h = host, s = std::move(conn), reusable]() mutable {
+                        p->release(*h, std::move(s), reusable);
+                    });
+                }
+                conn.reset();
+                host = nullptr;
+                pool.reset();
+            }
+
+          public:
+            lease() = default;
+            lease(const lease&) = delete;
+            lease& operator=(const lease&) = delete;
+
+            lease(lease&& l) noexcept :
+                    pool{std::move(l.pool)}, host{std::exchange(l.host, nullptr)}, conn{std::move(l.conn)} {}
+
+            lease& operator=(lease&& l) noexcept {
+                if (this != &l) {
+                    reset();
+                    pool = std::move(l.pool);
+                    host = std::exchange(l.host, nullptr);
+                    conn = std::move(l.conn);
+                }
+                return *this;
+            }
+
+            ~lease() { reset(); }
+
+            explicit operator bool() const noexcept { return static_cast<bool>(conn); }
+
+            stream& operator*() const noexcept { return *conn; }
+            stream* operator->() const noexcept { return conn.get(); }
+
+            const endpoint& target() const noexcept { return host->ep; }
+
+            // Returns the connection to the pool
+            void reset() { give_back(true); }
+
+            // Closes the connection rather than returning it, e.g. after a protocol error
+            void discard() { give_back(false); }
+        };
+
+        connection_pool(
+                Loop& _loop,
+                connection_pool_options _opts,
+                std::shared_ptr<typename Loop::ticker_group> ticker,
+                std::shared_ptr<typename Loop::dns_resolver> _resolver) :
+                loop{_loop.weak_from_this()},
+                opts{std::move(_opts)},
+                resolver{std::move(_resolver)},
+                sweeper{ticker ? std::move(ticker) : _loop.make_ticker_group(opts.sweep_interval)},
+                sweep_member{sweeper->join([this] { sweep(); })} {}
+
+        ~connection_pool() {
+            sweep_member.reset();
+
+            for (auto& [ep, h] : hosts) {
+                for (auto& cb : std::exchange(h.waiters, {})) {
+                    invoke(cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+                }
+            }
+
+            // each fails its acquire with operation_canceled; a dead loop's connects never complete, and
+            // their events went with its base
+            detail::release_on_loop(
+                    loop,
+                    [this] {
+                        for (auto& [ep, h] : hosts) {
+                            for (auto& c : std::exchange(h.connecting, {})) {
+                                c->cancel();
+                            }
+                        }
+                    },
+                    [] {});
+        }
+
+        connection_pool(const connection_pool&) = delete;
+        connection_pool& operator=(const connection_pool&) = delete;
+
+        /** Calls `cb` on the loop thread with a lease on a connection to `ep`, or the error that
+            prevented connecting. Always queued, even from the loop thread, so that an acquire never
+            overtakes a release made before it.
+         */
+        void acquire(endpoint ep, callback cb, std::source_location loc = std::source_location::current()) {
+            auto l = loop.lock();
+            auto posted = l and l->call_soon(
+                    [self = weak_self.lock(), ep = std::move(ep), cb]() mutable {
+                        auto& h = self->hosts.try_emplace(ep, ep).first->second;
+                        self->checkout(h, std::move(cb));
+                    },
+                    loc);
+
+            if (not posted) {
+                invoke(cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+            }
+        }
+
+        connection_pool_stats stats() const {
+            auto collect = [this] {
+                auto st = counters;
+                for (auto& [ep, h] : hosts) {
+                    st.open += h.open;
+                    st.idle += h.idle.size();
+                    st.waiting += h.waiters.size();
+                }
+                return st;
+            };
+            auto l = loop.lock();
+            return l ? l->call_get(collect) : collect();
+        }
+
+      private:
+        friend Loop;
+
+        std::weak_ptr<Loop> loop;
+        std::weak_ptr<connection_pool> weak_self;
+        connection_pool_options opts;
+
+        // host entries stay put while anything (lease, connect, waiter) refers to them
+        std::map<endpoint, host_state> hosts;
+        connection_pool_stats counters;
+
+        std::shared_ptr<typename Loop::dns_resolver> resolver;
+        std::shared_ptr<typename Loop::ticker_group> sweeper;
+        typename Loop::ticker_group::member sweep_member;
+
+        static void invoke(callback& cb, std::expected<lease, std::error_code> r) {
+            try {
+                cb(std::move(r));
+            } catch (const std::exception& e) {
+                unlog::critical(Loop::log, "Connection pool callback caught exception: {}", e.what());
+            }
+        }
+
+        void checkout(host_state& h, callback cb) {
+            if (auto s = take_idle(h)) {
+                ++counters.reuses;
+                hand(h, std::move(s), cb);
+            }
+            else if (h.open < opts.max_per_endpoint) {
+                ++h.open;
+                connect(h, std::move(cb));
+            }
+            else {
+                h.waiters.push_back(std::move(cb));
+            }
+        }
+
+        stream_ptr take_idle(host_state& h) {
+            while (not h.idle.empty()) {
+                auto s = std::move(h.idle.back().s);
+                h.idle.pop_back();
+                if (s->is_open()) {
+                    return s;
+                }
+                --h.open;
+            }
+            return nullptr;
+        }
+
+        void hand(host_state& h, stream_ptr s, callback& cb) {
+            s->on_data(nullptr);
+            s->on_close(nullptr);
+            invoke(cb, lease{weak_self, &h, std::move(s)});
+        }
+
+        void fail(host_state& h, callback& cb, std::error_code ec) {
+            --h.open;
+            invoke(cb, std::unexpected{ec});
+            serve_waiters(h);
+        }
+
+        // Gives waiters whatever a closed or returned connection has freed up
+        void serve_waiters(host_state& h) {
+            while (not h.waiters.empty() and (not h.idle.empty() or h.open < opts.max_per_endpoint)) {
+                auto cb = std::move(h.waiters.front());
+                h.waiters.pop_front();
+                checkout(h, std::move(cb));
+            }
+        }
+
+        void connect(host_state& h, callback cb) {
+            if (auto addrs = numeric_addresses(h.ep.host, h.ep.port); not addrs.empty()) {
+                dial(h, std::move(addrs), std::move(cb));
+                return;
+            }
+
+            if (resolver) {
+                resolver->resolve(h.ep.host, h.ep.port, [weak = weak_self, hp = &h, cb](dns_result r) mutable {
+                    auto self = weak.lock();
+                    if (not self) {
+                        invoke(cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+                        return;
+                    }
+                    if (not r) {
+                        self->fail(*hp, cb, r.error());
+                        return;
+                    }
+                    self->dial(*hp, std::move(*r), std::move(cb));
+                });
+                return;
+            }
+
+            auto l = loop.lock();
+            auto started = l and l->call_blocking(
+                    [ep = h.ep] { return resolve_addresses(ep.host, ep.port); },
+                    [weak = weak_self, hp = &h, cb](blocking_result<std::vector<sock_address>> r) mutable {
+                        auto self = weak.lock();
+                        if (not self) {
+                            invoke(cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+                            return;
+                        }
+                        if (not r) {
+                            self->fail(*hp, cb, error_of(r.error()));
+                            return;
+                        }
+                        if (r->empty()) {
+                            self->fail(*hp, cb, std::make_error_code(std::errc::host_unreachable));
+                            return;
+                        }
+                        self->dial(*hp, std::move(*r), std::move(cb));
+                    });
+
+            if (not started) {
+                fail(h, cb, std::make_error_code(std::errc::operation_canceled));
+            }
+        }
+
+        void dial(host_state& h, std::vector<sock_address> addrs, callback cb) {
+            auto l = loop.lock();
+            if (not l) {
+                fail(h, cb, std::make_error_code(std::errc::operation_canceled));
+                return;
+            }
+
+            std::shared_ptr<tcp_connect> c;
+            try {
+                c = tcp_connect::start(
+                        l->loop(),
+                        std::move(addrs),
+                        [this, hp = &h, cb](std::error_code ec, evutil_socket_t fd) mutable {
+                            std::erase_if(hp->connecting, [](const auto& t) { return t->finished(); });
+
+                            if (ec) {
+                                fail(*hp, cb, ec);
+                                return;
+                            }
+
+                            auto l = loop.lock();
+                            if (not l) {
+                                evutil_closesocket(fd);
+                                fail(*hp, cb, std::make_error_code(std::errc::operation_canceled));
+                                return;
+                            }
+
+                            stream_ptr s;
+                            try {
+                                s = l->make_stream(fd);
+                            } catch (const std::exception&) {
+                                fail(*hp, cb, std::make_error_code(std::errc::not_enough_memory));
+                                return;
+                            }
+
+                            ++counters.connects;
+                            hand(*hp, std::move(s), cb);
+                        },
+                        opts.connect);
+            } catch (const std::exception&) {
+                // `cb` was copied into the completion, so it is still ours to fail
+                fail(h, cb, std::make_error_code(std::errc::not_enough_memory));
+                return;
+            }
+
+            h.connecting.push_back(std::move(c));
+        }
+
+        void release(host_state& h, stream_ptr s, bool reusable) {
+            auto l = loop.lock();
+            if (l and reusable and s->is_open() and s->pending_output() == 0 and evbuffer_get_length(s->input()) == 0) {
+                if (not h.waiters.empty()) {
+                    auto cb = std::move(h.waiters.front());
+                    h.waiters.pop_front();
+                    ++counters.reuses;
+                    hand(h, std::move(s), cb);
+                    return;
+                }
+                if (h.idle.size() < opts.max_idle_per_endpoint) {
+                    // nothing should arrive on an idle connection; treat it as broken if it does
+                    s->on_data([](stream& st) { st.close(); });
+                    h.idle.push_back({std::move(s), l->now()});
+                    return;
+                }
+            }
+
+            --h.open;
+            s.reset();
+            serve_waiters(h);
+        }
+
+        void sweep() {
+            auto l = loop.lock();
+            if (not l) {
+                return;
+            }
+            auto cutoff = l->now() - opts.idle_timeout;
+
+            for (auto it = hosts.begin(); it != hosts.end();) {
+                auto& h = it->second;
+
+                auto n = std::erase_if(
+                        h.idle, [cutoff](const idle_conn& c) { return c.since <= cutoff or not c.s->is_open(); });
+                if (n > 0) {
+                    h.open -= n;
+                    serve_waiters(h);
+                }
+
+                if (h.open == 0 and h.waiters.empty()) {
+                    it = hosts.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        static std::error_code error_of(const std::exception_ptr& e) {
+            try {
+                std::rethrow_exception(e);
+            } catch (const std::system_error& se) {
+                return se.code();
+            } catch (...) {
+                return std::make_error_code(std::errc::host_unreachable);
+            }
+        }
+    };
+}  // namespace un::event
@@ -0,0 +1,335 @@
+#pragma once
+
+#include "connect.hpp"
+#include "utils.hpp"
+
+#include <event2/dns.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace un::event {
+    // Error category of evdns result codes (DNS_ERR_NOTEXIST for NXDOMAIN, DNS_ERR_TIMEOUT, ...)
+    const std::error_category& dns_category() noexcept;
+
+    inline std::error_code make_dns_error(int err) noexcept { return {err, dns_category()}; }
+
+    using dns_result = std::expected<std::vector<sock_address>, std::error_code>;
+
+    struct dns_cache_options {
+        // answers are kept for their record TTL, clamped to these bounds
+        std::chrono::seconds min_ttl{0s};
+        std::chrono::seconds max_ttl{1h};
+        // names that do not exist (or have no addresses) are remembered this long
+        std::chrono::seconds negative_ttl{30s};
+        // expired entries are dropped to make room beyond this, then those closest to expiring
+        size_t max_entries{4096};
+    };
+
+    struct dns_cache_stats {
+        size_t hits{0};
+        size_t negative_hits{0};
+        size_t misses{0};
+        size_t entries{0};
+    };
+
+    /** Resolved names shared by any number of `dns_resolver`s, typically one per loop of a pool,
+        so a name looked up on one loop is answered from memory on the others. Addresses are stored
+        without a port. Thread-safe; lookups take a single mutex.
+     */
+    class dns_cache {
+        struct entry {
+            std::vector<sock_address> addrs;
+            std::error_code error;
+            std::chrono::steady_clock::time_point expires;
+        };
+
+        const dns_cache_options opts;
+        mutable std::mutex mutex;
+        std::map<std::string, entry, std::less<>> entries;
+        dns_cache_stats counters;
+
+        void make_room(std::chrono::steady_clock::time_point now);
+
+      public:
+        explicit dns_cache(dns_cache_options _opts = {}) : opts{_opts} {}
+
+        dns_cache(const dns_cache&) = delete;
+        dns_cache& operator=(const dns_cache&) = delete;
+
+        // The live answer for `host`, if any: its addresses, or the error it was negatively cached with
+        std::optional<dns_result> lookup(std::string_view host);
+
+        void store(std::string_view host, std::vector<sock_address> addrs, std::chrono::seconds ttl);
+        void store_negative(std::string_view host, std::error_code ec);
+
+        void clear();
+
+        dns_cache_stats stats() const;
+    };
+
+    struct dns_options {
+        // "ip" or "ip:port" nameservers to query; when empty, those of `resolv_conf` are used
+        std::vector<std::string> nameservers;
+        std::string resolv_conf{"/etc/resolv.conf"};
+        // names answered locally before any query; empty for none
+        std::string hosts_file{"/etc/hosts"};
+        std::chrono::milliseconds timeout{5s};
+        int attempts{2};
+        // query AAAA alongside A
+        bool ipv6{true};
+        // shared between resolvers; each resolver makes its own when null
+        std::shared_ptr<dns_cache> cache;
+    };
+
+    namespace detail {
+        using hosts_table = std::map<std::string, std::vector<sock_address>, std::less<>>;
+
+        // Parses a hosts(5) file; names are lowercased. A missing file gives an empty table.
+        hosts_table load_hosts(const std::string& path);
+
+        // evdns base on `base` configured from `opts`; throws std::runtime_error if it cannot be made
+        evdns_base* make_evdns_base(event_base* base, const dns_options& opts);
+
+        std::string normalize_host(std::string_view host);
+
+        // Copy of `addrs` with every port set to `port`
+        std::vector<sock_address> with_port(std::vector<sock_address> addrs, uint16_t port);
+
+        // Converts the address array of an evdns answer
+        void append_answer(std::vector<sock_address>& out, char type, int count, const void* addresses);
+    }  // namespace detail
+
+    /** Asynchronous name resolution on one loop (libevent's evdns), answering from, in order: numeric
+        addresses, the hosts file, the `dns_cache`, and then A and AAAA queries sent together. IPv6
+        addresses come first in a result, ready for `tcp_connect` to race. Concurrent resolves of a
+        name already being queried wait for that query rather than sending their own.
+
+        Successful answers are cached for their TTL; names that do not exist, or have no addresses,
+        for the cache's `negative_ttl`. Timeouts and server failures are not cached.
+
+        Created with `unevent_loop::make_resolver` (or `loop_pool::make_resolvers`, which shares one
+        cache across the pool); `resolve` may be called from any thread. The resolver does not keep
+        its loop alive; once the loop is gone, resolves fail with operation_canceled.
+     */
+    template <typename Loop>
+    class dns_resolver {
+      public:
+        using callback = std::function<void(dns_result)>;
+
+      private:
+        struct waiter {
+            uint16_t port;
+            callback cb;
+        };
+
+        struct query {
+            dns_resolver* owner;
+            std::string host;
+            std::vector<waiter> waiters;
+            std::vector<sock_address> v4, v6;
+            int v4_err{DNS_ERR_NONE};
+            int v6_err{DNS_ERR_NONE};
+            int ttl{-1};
+            int outstanding{0};
+        };
+
+        friend Loop;
+
+        std::weak_ptr<Loop> loop;
+        std::weak_ptr<dns_resolver> weak_self;
+        // failing outstanding requests guarantees each query exactly one callback per family
+        std::unique_ptr<evdns_base, void (*)(evdns_base*)> dns{nullptr, [](evdns_base* b) { evdns_base_free(b, 1); }};
+        const bool ipv6;
+        detail::hosts_table hosts;
+        std::shared_ptr<dns_cache> cache;
+        std::map<std::string, std::unique_ptr<query>, std::less<>> inflight;
+
+        static void invoke(callback& cb, dns_result r) {
+            try {
+                cb(std::move(r));
+            } catch (const std::exception& e) {
+                unlog::critical(Loop::log, "DNS resolve callback caught exception: {}", e.what());
+            }
+        }
+
+        // One instantiation per family: evdns reports failures with `type` 0, so it cannot tell them apart
+        template <bool IPv6>
+        static void on_answer(int result, char type, int count, int ttl, void* addresses, void* arg) {
+            auto& q = *static_cast<query*>(arg);
+            if (not q.owner) {
+                // abandoned by a destroyed resolver, whose evdns base may still deliver answers late
+                if (--q.outstanding == 0) {
+                    delete &q;
+                }
+                return;
+            }
+
+            if (result == DNS_ERR_NONE) {
+                detail::append_answer(IPv6 ? q.v6 : q.v4, type, count, addresses);
+                q.ttl = q.ttl < 0 ? ttl : std::min(q.ttl, ttl);
+            }
+            (IPv6 ? q.v6_err : q.v4_err) = result;
+
+            if (--q.outstanding == 0) {
+                q.owner->complete(q.host);
+            }
+        }
+
+        void complete(std::string_view host) {
+            auto it = inflight.find(host);
+            auto q = std::move(it->second);
+            inflight.erase(it);
+
+            dns_result r;
+            if (not q->v4.empty() or not q->v6.empty()) {
+                auto addrs = std::move(q->v6);
+                addrs.insert(addrs.end(), q->v4.begin(), q->v4.end());
+                cache->store(q->host, addrs, std::chrono::seconds{std::max(q->ttl, 0)});
+                r = std::move(addrs);
+            }
+            else {
+                auto missing = [](int e) { return e == DNS_ERR_NOTEXIST or e == DNS_ERR_NODATA or e == DNS_ERR_NONE; };
+                if (missing(q->v4_err) and missing(q->v6_err)) {
+                    int e = (q->v4_err == DNS_ERR_NOTEXIST or q->v6_err == DNS_ERR_NOTEXIST) ? DNS_ERR_NOTEXIST
+                                                                                            : DNS_ERR_NODATA;
+                    cache->store_negative(q->host, make_dns_error(e));
+                    r = std::unexpected{make_dns_error(e)};
+                }
+                else {
+                    r = std::unexpected{make_dns_error(q->v4_err != DNS_ERR_NONE ? q->v4_err : q->v6_err)};
+                }
+            }
+
+            for (auto& w : q->waiters) {
+                invoke(w.cb, r ? dns_result{detail::with_port(*r, w.port)} : r);
+            }
+        }
+
+        void start(std::string host, uint16_t port, callback cb) {
+            if (auto addrs = numeric_addresses(host, port); not addrs.empty()) {
+                invoke(cb, std::move(addrs));
+                return;
+            }
+
+            auto name = detail::normalize_host(host);
+
+            if (auto it = hosts.find(name); it != hosts.end()) {
+                invoke(cb, detail::with_port(it->second, port));
+                return;
+            }
+
+            if (auto hit = cache->lookup(name)) {
+                invoke(cb, *hit ? dns_result{detail::with_port(std::move(**hit), port)} : std::move(*hit));
+                return;
+            }
+
+            if (auto it = inflight.find(name); it != inflight.end()) {
+                it->second->waiters.push_back({port, std::move(cb)});
+                return;
+            }
+
+            auto q = std::make_unique<query>(this, name);
+            q->waiters.push_back({port, std::move(cb)});
+            auto& qr = *q;
+            inflight.emplace(name, std::move(q));
+
+            // each launch may answer at once (e.g. with no nameservers), so count both before either
+            qr.outstanding = ipv6 ? 2 : 1;
+            if (not evdns_base_resolve_ipv4(dns.get(), name.c_str(), 0, &dns_resolver::on_answer<false>, &qr)) {
+                on_answer<false>(DNS_ERR_UNKNOWN, DNS_IPv4_A, 0, 0, nullptr, &qr);
+            }
+            if (ipv6 and
+                not evdns_base_resolve_ipv6(dns.get(), name.c_str(), 0, &dns_resolver::on_answer<true>, &qr)) {
+                on_answer<true>(DNS_ERR_UNKNOWN, DNS_IPv6_AAAA, 0, 0, nullptr, &qr);
+            }
+        }
+
+      public:
+        dns_resolver(Loop& _loop, const dns_options& opts) :
+                loop{_loop.weak_from_this()},
+                ipv6{opts.ipv6},
+                hosts{opts.hosts_file.empty() ? detail::hosts_table{} : detail::load_hosts(opts.hosts_file)},
+                cache{opts.cache ? opts.cache : std::make_shared<dns_cache>()} {
+            dns.reset(detail::make_evdns_base(_loop.loop(), opts));
+        }
+
+        ~dns_resolver() {
+            auto pending = std::exchange(inflight, {});
+            for (auto& [name, q] : pending) {
+                q->owner = nullptr;
+            }
+            // queues DNS_ERR_SHUTDOWN for every outstanding query, to be delivered on a later loop turn;
+            // a dead loop's base is gone, so its evdns base is left behind and nothing will answer
+            bool answered{false};
+            detail::release_on_loop(
+                    loop,
+                    [&] {
+                        dns.reset();
+                        answered = true;
+                    },
+                    [this] { (void)dns.release(); });
+
+            for (auto& [name, q] : pending) {
+                for (auto& w : std::exchange(q->waiters, {})) {
+                    invoke(w.cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+                }
+                if (answered) {
+                    // freed by its last callback
+                    (void)q.release();
+                }
+            }
+        }
+
+        dns_resolver(const dns_resolver&) = delete;
+        dns_resolver& operator=(const dns_resolver&) = delete;
+
+        /** Calls `cb` with the addresses of `host`, each with `port` set, or the error that prevented
+            resolving it. Answers known without a query (numeric, hosts, cached) are delivered before
+            `resolve` returns when called on the loop thread; anything else is called back there.
+         */
+        void resolve(
+                std::string host, uint16_t port, callback cb, std::source_location loc = std::source_location::current()) {
+            auto l = loop.lock();
+            if (not l) {
+                invoke(cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+                return;
+            }
+            if (l->in_event_loop()) {
+                start(std::move(host), port, std::move(cb));
+                return;
+            }
+
+            auto posted = l->call_soon(
+                    [weak = weak_self, host = std::move(host), port, cb]() mutable {
+                        if (auto self = weak.lock()) {
+                            self->start(std::move(host), port, std::move(cb));
+                        }
+                        else {
+                            invoke(cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+                        }
+                    },
+                    loc);
+            if (not posted) {
+                invoke(cb, std::unexpected{std::make_error_code(std::errc::operation_canceled)});
+            }
+        }
+
+        const std::shared_ptr<dns_cache>& shared_cache() const noexcept { return cache; }
+
+        evdns_base* native() const noexcept { return dns.get(); }
+    };
+}  // namespace un::event
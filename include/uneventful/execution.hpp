@@ -0,0 +1,333 @@
+#pragma once
+
+#include "loop.hpp"
+#include "loop_pool.hpp"
+
+#include <event2/event_struct.h>
+
+#include <concepts>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <semaphore>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace un::event::exec {
+    /** A small sender/receiver layer in the shape of P2300 (std::execution), sized to what the loops
+        need and without its customization-point machinery:
+
+            - a receiver is any object with `set_value(Ts...)` (zero or one argument),
+              `set_error(std::exception_ptr)` and `set_stopped()`, each noexcept in practice
+            - a sender exposes `value_type` (void or the single value type) and
+              `connect(receiver) -> operation state`
+            - an operation state is immovable, lives wherever the caller puts it, and begins work on
+              `start()`; it must stay alive until one of the receiver's completions has been called
+
+        Operation states for `schedule()` link themselves into the loop's intrusive job list, those
+        for `schedule_after()` embed their libevent timer as well, and `then` nests the upstream operation
+        state inside its own, so a whole pipeline is a single object in the caller's frame.
+     */
+
+    template <typename S>
+    concept sender = requires { typename std::remove_cvref_t<S>::value_type; };
+
+    template <typename S>
+    using value_type_of = typename std::remove_cvref_t<S>::value_type;
+
+    template <typename Loop>
+    class loop_scheduler {
+        Loop* _loop;
+
+      public:
+        explicit loop_scheduler(Loop& l) noexcept : _loop{&l} {}
+
+        Loop& loop() const noexcept { return *_loop; }
+
+        // Completes with set_value() on the loop thread, or set_stopped() if the loop shuts down first
+        struct schedule_sender {
+            using value_type = void;
+
+            Loop* loop;
+
+            template <typename R>
+            struct operation : un::event::detail::intrusive_job {
+                Loop* loop;
+                R rcv;
+
+                operation(Loop* l, R r) :
+                        un::event::detail::intrusive_job{.run = &operation::execute}, loop{l}, rcv{std::move(r)} {}
+                operation(const operation&) = delete;
+                operation& operator=(const operation&) = delete;
+
+                void start() noexcept {
+                    if (not loop->post(this)) {
+                        rcv.set_stopped();
+                    }
+                }
+
+                static void execute(un::event::detail::intrusive_job* j, bool cancelled) noexcept {
+                    auto& op = *static_cast<operation*>(j);
+                    cancelled ? op.rcv.set_stopped() : op.rcv.set_value();
+                }
+            };
+
+            template <typename R>
+            operation<std::remove_cvref_t<R>> connect(R&& r) const {
+                return {loop, std::forward<R>(r)};
+            }
+        };
+
+        /** Completes with set_value() on the loop thread once `delay` has elapsed since `start()`, or
+            set_stopped() if the loop shuts down first. The timer is armed from the loop thread and
+            tracked by the loop, which disarms it on shutdown, so an operation may outlive its loop.
+         */
+        struct schedule_after_sender {
+            using value_type = void;
+
+            Loop* loop;
+            std::chrono::microseconds delay;
+
+            template <typename R>
+            struct operation : un::event::detail::intrusive_job, un::event::detail::tracked_op {
+                Loop* loop;
+                std::chrono::microseconds delay;
+                R rcv;
+                std::chrono::steady_clock::time_point due{};
+                ::event ev{};
+                bool armed{false};
+
+                operation(Loop* l, std::chrono::microseconds d, R r) :
+                        un::event::detail::intrusive_job{.run = &operation::arm},
+                        un::event::detail::tracked_op{.stop = &operation::stop},
+                        loop{l},
+                        delay{d},
+                        rcv{std::move(r)} {}
+                operation(const operation&) = delete;
+                operation& operator=(const operation&) = delete;
+
+                ~operation() {
+                    // only reachable while armed if the owner abandons a pending operation
+                    if (armed) {
+                        loop->call_get([this] {
+                            if (std::exchange(armed, false)) {
+                                event_del(&ev);
+                                loop->untrack(this);
+                            }
+                        });
+                    }
+                }
+
+                void start() noexcept {
+                    due = un::event::detail::get_time() + delay;
+                    if (not loop->post(this)) {
+                        rcv.set_stopped();
+                    }
+                }
+
+                static void arm(un::event::detail::intrusive_job* j, bool cancelled) noexcept {
+                    auto& op = *static_cast<operation*>(j);
+                    if (cancelled) {
+                        op.rcv.set_stopped();
+                        return;
+                    }
+
+                    auto left = std::chrono::ceil<std::chrono::microseconds>(op.due - un::event::detail::get_time());
+                    auto tv = loop_time_to_timeval(std::max(left, std::chrono::microseconds{0}));
+
+                    evtimer_assign(&op.ev, op.loop->loop(), &operation::fire, &op);
+                    if (evtimer_add(&op.ev, &tv) != 0) {
+                        op.rcv.set_error(
+                                std::make_exception_ptr(std::runtime_error{"Failed to arm schedule_after timer"}));
+                        return;
+                    }
+                    op.armed = true;
+                    op.loop->track(&op);
+                }
+
+                static void fire(evutil_socket_t, short, void* arg) {
+                    auto& op = *static_cast<operation*>(arg);
+                    op.armed = false;
+                    op.loop->untrack(&op);
+                    op.rcv.set_value();
+                }
+
+                static void stop(un::event::detail::tracked_op* t) noexcept {
+                    auto& op = *static_cast<operation*>(t);
+                    event_del(&op.ev);
+                    op.armed = false;
+                    op.rcv.set_stopped();
+                }
+            };
+
+            template <typename R>
+            operation<std::remove_cvref_t<R>> connect(R&& r) const {
+                return {loop, delay, std::forward<R>(r)};
+            }
+        };
+
+        schedule_sender schedule() const noexcept { return {_loop}; }
+
+        schedule_after_sender schedule_after(std::chrono::microseconds delay) const noexcept { return {_loop, delay}; }
+
+        friend bool operator==(const loop_scheduler& a, const loop_scheduler& b) noexcept { return a._loop == b._loop; }
+    };
+
+    // Round-robins each `schedule`/`schedule_after` across the loops of a `loop_pool`
+    template <typename Pool>
+    class pool_scheduler {
+        Pool* pool;
+
+      public:
+        explicit pool_scheduler(Pool& p) noexcept : pool{&p} {}
+
+        auto schedule() const noexcept { return loop_scheduler{*pool->next()}.schedule(); }
+
+        auto schedule_after(std::chrono::microseconds delay) const noexcept {
+            return loop_scheduler{*pool->next()}.schedule_after(delay);
+        }
+
+        friend bool operator==(const pool_scheduler& a, const pool_scheduler& b) noexcept { return a.pool == b.pool; }
+    };
+
+    template <auto& C>
+    loop_scheduler<unevent_loop<C>> get_scheduler(unevent_loop<C>& loop) noexcept {
+        return loop_scheduler<unevent_loop<C>>{loop};
+    }
+
+    template <auto& C>
+    pool_scheduler<loop_pool<C>> get_scheduler(loop_pool<C>& pool) noexcept {
+        return pool_scheduler<loop_pool<C>>{pool};
+    }
+
+    namespace detail {
+        template <typename F, typename V>
+        struct then_result {
+            using type = std::invoke_result_t<F, V>;
+        };
+
+        template <typename F>
+        struct then_result<F, void> {
+            using type = std::invoke_result_t<F>;
+        };
+
+        template <typename F, typename R>
+        struct then_receiver {
+            F f;
+            R rcv;
+
+            template <typename... Vs>
+            void set_value(Vs&&... vs) noexcept {
+                try {
+                    if constexpr (std::is_void_v<std::invoke_result_t<F, Vs...>>) {
+                        std::invoke(f, std::forward<Vs>(vs)...);
+                        rcv.set_value();
+                    }
+                    else {
+                        rcv.set_value(std::invoke(f, std::forward<Vs>(vs)...));
+                    }
+                } catch (...) {
+                    rcv.set_error(std::current_exception());
+                }
+            }
+
+            void set_error(std::exception_ptr e) noexcept { rcv.set_error(std::move(e)); }
+            void set_stopped() noexcept { rcv.set_stopped(); }
+        };
+    }  // namespace detail
+
+    template <sender S, typename F>
+    struct then_sender {
+        using value_type = typename detail::then_result<F, value_type_of<S>>::type;
+
+        S upstream;
+        F f;
+
+        template <typename R>
+        auto connect(R&& r) && {
+            return std::move(upstream).connect(
+                    detail::then_receiver<F, std::remove_cvref_t<R>>{std::move(f), std::forward<R>(r)});
+        }
+
+        template <typename R>
+        auto connect(R&& r) const& {
+            return upstream.connect(detail::then_receiver<F, std::remove_cvref_t<R>>{f, std::forward<R>(r)});
+        }
+    };
+
+    // Runs `f` on the upstream's value, on whichever thread the upstream completes
+    template <sender S, typename F>
+    then_sender<std::remove_cvref_t<S>, std::decay_t<F>> then(S&& s, F&& f) {
+        return {std::forward<S>(s), std::forward<F>(f)};
+    }
+
+    template <typename F>
+    struct then_closure {
+        F f;
+
+        template <sender S>
+        friend auto operator|(S&& s, then_closure c) {
+            return then(std::forward<S>(s), std::move(c.f));
+        }
+    };
+
+    // Pipeable form: `sched.schedule() | then(f)`
+    template <typename F>
+    then_closure<std::decay_t<F>> then(F&& f) {
+        return {std::forward<F>(f)};
+    }
+
+    template <typename T>
+    using sync_wait_result = std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>>;
+
+    namespace detail {
+        template <typename T>
+        struct sync_wait_state {
+            sync_wait_result<T> result{};
+            std::exception_ptr error{};
+            std::binary_semaphore done{0};
+        };
+
+        template <typename T>
+        struct sync_wait_receiver {
+            sync_wait_state<T>* st;
+
+            template <typename... Vs>
+            void set_value(Vs&&... vs) noexcept {
+                if constexpr (sizeof...(Vs) == 0) {
+                    st->result.emplace();
+                }
+                else {
+                    st->result.emplace(std::forward<Vs>(vs)...);
+                }
+                st->done.release();
+            }
+
+            void set_error(std::exception_ptr e) noexcept {
+                st->error = std::move(e);
+                st->done.release();
+            }
+
+            void set_stopped() noexcept { st->done.release(); }
+        };
+    }  // namespace detail
+
+    /** Starts `s` and blocks the calling thread until it completes. Returns the value (std::monostate
+        for void senders), nullopt if it was stopped, and rethrows an error completion. Never call
+        this from the thread of a loop the sender needs in order to complete.
+     */
+    template <sender S>
+    sync_wait_result<value_type_of<S>> sync_wait(S&& s) {
+        detail::sync_wait_state<value_type_of<S>> st;
+
+        auto op = std::forward<S>(s).connect(detail::sync_wait_receiver<value_type_of<S>>{&st});
+        op.start();
+        st.done.acquire();
+
+        if (st.error) {
+            std::rethrow_exception(st.error);
+        }
+        return std::move(st.result);
+    }
+}  // namespace un::event::exec
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace un::event {
+    template <typename T>
+    class loop_future;
+
+    namespace detail {
+        /** Shared state behind a `loop_future`: the result slot and the continuation live in the one
+            allocation made by std::make_shared. Completion and continuation registration each set a
+            bit with a single fetch_or; whichever side sets the second bit fires the continuation, so
+            neither side ever locks or blocks.
+         */
+        template <typename T>
+        class future_state : public std::enable_shared_from_this<future_state<T>> {
+            template <typename>
+            friend class un::event::loop_future;
+            template <typename>
+            friend class future_producer;
+
+            using value_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+            static constexpr uint8_t has_result{1};
+            static constexpr uint8_t has_continuation{2};
+
+            std::atomic<uint8_t> flags{0};
+            std::atomic<uint32_t> producers{0};
+            std::optional<value_t> value{};
+            std::exception_ptr error{};
+            std::function<void(std::shared_ptr<future_state>)> continuation{};
+
+            void publish(uint8_t bit) {
+                auto prior = flags.fetch_or(bit, std::memory_order_acq_rel);
+                if (prior == (bit ^ (has_result | has_continuation))) {
+                    continuation(this->shared_from_this());
+                }
+            }
+
+          public:
+            template <typename... Vs>
+            void set_value(Vs&&... vs) {
+                value.emplace(std::forward<Vs>(vs)...);
+                publish(has_result);
+            }
+
+            void set_error(std::exception_ptr e) {
+                error = std::move(e);
+                publish(has_result);
+            }
+
+            // Invokes `f(args...)` and stores its result, or the exception it throws
+            template <typename F, typename... Args>
+            void fulfil(F& f, Args&&... args) {
+                try {
+                    if constexpr (std::is_void_v<T>) {
+                        std::invoke(f, std::forward<Args>(args)...);
+                        set_value();
+                    }
+                    else {
+                        set_value(std::invoke(f, std::forward<Args>(args)...));
+                    }
+                } catch (...) {
+                    set_error(std::current_exception());
+                }
+            }
+
+            bool ready() const noexcept { return flags.load(std::memory_order_acquire) & has_result; }
+        };
+
+        /** Handle a queued job holds to fill in a `future_state`. Copies count as one producer; when
+            the last is destroyed without a result, as happens to a job a shutdown drops unrun, the
+            future fails instead of never completing.
+        */
+        template <typename T>
+        class future_producer {
+            std::shared_ptr<future_state<T>> st;
+
+          public:
+            explicit future_producer(std::shared_ptr<future_state<T>> s) noexcept : st{std::move(s)} {
+                st->producers.fetch_add(1, std::memory_order_relaxed);
+            }
+            future_producer(const future_producer& other) noexcept : st{other.st} {
+                if (st) {
+                    st->producers.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            future_producer(future_producer&&) noexcept = default;
+            future_producer& operator=(const future_producer&) = delete;
+
+            ~future_producer() {
+                if (st and st->producers.fetch_sub(1, std::memory_order_acq_rel) == 1 and not st->ready()) {
+                    st->set_error(std::make_exception_ptr(std::runtime_error{"Loop is shutting down"}));
+                }
+            }
+
+            future_state<T>& operator*() const noexcept { return *st; }
+            future_state<T>* operator->() const noexcept { return st.get(); }
+        };
+
+        template <typename F, typename T>
+        struct continuation_result {
+            using type = std::invoke_result_t<F, T&&>;
+        };
+
+        template <typename F>
+        struct continuation_result<F, void> {
+            using type = std::invoke_result_t<F>;
+        };
+    }  // namespace detail
+
+    /** Non-blocking result of `unevent_loop::call_async`. The only way to consume it is `then`, which
+        posts a continuation to a chosen loop once the result is available (immediately if it already
+        is) and returns a future for the continuation's own result, so loops can request work from
+        one another without any thread ever waiting. An exception thrown by the producer or by any
+        continuation skips the remaining continuations and surfaces in `then_or_error` handlers, as
+        does a continuation loop refusing the post, or dropping it unrun, because it is shutting down.
+
+        Each future is consumed by a single `then`; the future is empty afterwards.
+     */
+    template <typename T>
+    class loop_future {
+        std::shared_ptr<detail::future_state<T>> st;
+
+        template <typename R, typename Loop, typename Body>
+        loop_future<R> chain(Loop& loop, Body body) && {
+            if (not st) {
+                throw std::logic_error{"loop_future has already been consumed"};
+            }
+
+            auto next = std::make_shared<detail::future_state<R>>();
+            auto* src = st.get();
+
+            src->continuation = [next = detail::future_producer<R>{next},
+                                 weak_loop = loop.weak_from_this(),
+                                 b = std::move(body)](std::shared_ptr<detail::future_state<T>> ready) mutable {
+                auto l = weak_loop.lock();
+                if (not l) {
+                    next->set_error(std::make_exception_ptr(std::runtime_error{"Continuation loop no longer exists"}));
+                    return;
+                }
+                auto posted =
+                        l->call_soon([ready = std::move(ready), next, b = std::move(b)]() mutable { b(*ready, *next); });
+                if (not posted) {
+                    next->set_error(std::make_exception_ptr(std::runtime_error{"Loop is shutting down"}));
+                }
+            };
+
+            std::exchange(st, nullptr)->publish(detail::future_state<T>::has_continuation);
+
+            return loop_future<R>{std::move(next)};
+        }
+
+      public:
+        using value_type = T;
+
+        loop_future() = default;
+        explicit loop_future(std::shared_ptr<detail::future_state<T>> s) noexcept : st{std::move(s)} {}
+
+        bool valid() const noexcept { return st != nullptr; }
+
+        bool ready() const noexcept { return st and st->ready(); }
+
+        // Runs `f(value)` (or `f()` for void) on `loop` once ready; errors propagate past `f`
+        template <typename Loop, typename F>
+        auto then(Loop& loop, F&& f) && {
+            using R = typename detail::continuation_result<std::decay_t<F>, T>::type;
+
+            return std::move(*this).template chain<R>(
+                    loop,
+                    [fn = std::forward<F>(f)](detail::future_state<T>& in, detail::future_state<R>& out) mutable {
+                        if (in.error) {
+                            out.set_error(in.error);
+                        }
+                        else if constexpr (std::is_void_v<T>) {
+                            out.fulfil(fn);
+                        }
+                        else {
+                            out.fulfil(fn, std::move(*in.value));
+                        }
+                    });
+        }
+
+        // Runs `f(std::exception_ptr)` on `loop` if this future (or any step before it) failed, and
+        // passes a successful value through untouched; the error still propagates afterwards
+        template <typename Loop, std::invocable<std::exception_ptr> F>
+        loop_future then_or_error(Loop& loop, F&& f) && {
+            return std::move(*this).template chain<T>(
+                    loop,
+                    [fn = std::forward<F>(f)](detail::future_state<T>& in, detail::future_state<T>& out) mutable {
+                        if (in.error) {
+                            try {
+                                fn(in.error);
+                                out.set_error(in.error);
+                            } catch (...) {
+                                out.set_error(std::current_exception());
+                            }
+                        }
+                        else if constexpr (std::is_void_v<T>) {
+                            out.set_value();
+                        }
+                        else {
+                            out.set_value(std::move(*in.value));
+                        }
+                    });
+        }
+    };
+}  // namespace un::event
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "trace.hpp"
+#include "utils.hpp"
+
+#include <event2/buffer.h>
+#include <event2/http.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace un::event {
+    struct http_options {
+        // numeric IPv4 or IPv6 address to listen on
+        std::string address{"127.0.0.1"};
+        // 0 picks a free port; see `http_server::port()`
+        uint16_t port{0};
+        // lets several servers (one per loop of a pool) listen on the same port, the kernel spreading
+        // incoming connections between them
+        bool reuse_port{false};
+        int backlog{-1};
+        size_t max_headers_size{16U << 10};
+        size_t max_body_size{1U << 20};
+        // idle keep-alive connections, and requests that are slow to arrive, are closed after this
+        std::chrono::seconds timeout{30s};
+    };
+
+    /** One request received by an `http_server`, and the obligation to answer it. The handle may be
+        kept past the handler to answer later (responses on a connection still go out in request
+        order, see `http_server`), but it must be used and destroyed on the server's loop thread.
+        Dropping it unanswered replies 500, or ends the response if it was streaming.
+
+        A response is either complete, sent by one `reply`, or streamed with chunked encoding
+        between `start` and `end`. The `_ref` variants and those taking an evbuffer send the bytes
+        without copying them: a referenced span must stay valid until libevent has written it, which
+        `owner` (if given) guarantees by being held until then.
+     */
+    class http_request {
+        evhttp_request* req{nullptr};
+        bool streaming{false};
+
+        // The request, throwing std::logic_error if it has been answered or is (or is not) streaming
+        evhttp_request* pending() const;
+        evhttp_request* unstarted() const;
+        evhttp_request* started() const;
+
+      public:
+        http_request() = default;
+        explicit http_request(evhttp_request* r) noexcept : req{r} {}
+
+        http_request(const http_request&) = delete;
+        http_request& operator=(const http_request&) = delete;
+
+        http_request(http_request&& r) noexcept :
+                req{std::exchange(r.req, nullptr)}, streaming{std::exchange(r.streaming, false)} {}
+
+        http_request& operator=(http_request&& r) noexcept;
+
+        ~http_request();
+
+        // False once the response has been sent (or ended)
+        explicit operator bool() const noexcept { return req != nullptr; }
+
+        evhttp_cmd_type method() const;
+        std::string_view path() const;
+        // Query string without the leading '?', empty if there is none
+        std::string_view query() const;
+        std::optional<std::string_view> header(const char* name) const;
+        // Contiguous view of the request body; linearizes the input buffer on first use
+        std::string_view body() const;
+        evbuffer* input() const;
+
+        // False once the client has gone; anything sent afterwards is discarded
+        bool connected() const;
+        // Bytes of response queued on the connection but not yet written to the socket
+        size_t pending_output() const;
+
+        // Must come before `reply` or `start`
+        void add_header(const char* name, const char* value);
+
+        void reply(int code, std::string_view body = {});
+        // Moves the contents of `body` into the response
+        void reply(int code, evbuffer* body);
+        void reply_ref(int code, std::string_view body, std::shared_ptr<const void> owner = nullptr);
+        // Replies with libevent's stock error page for `code` and closes the connection afterwards
+        void error(int code);
+
+        // Sends the status line and headers of a chunked response
+        void start(int code);
+        void chunk(std::string_view data);
+        void chunk(evbuffer* data);
+        void chunk_ref(std::string_view data, std::shared_ptr<const void> owner = nullptr);
+        void end();
+
+        evhttp_request* native() const noexcept { return req; }
+    };
+
+    namespace detail {
+        // Applies `opts` to `http` and starts it listening on `base`; returns the bound port
+        uint16_t http_listen(event_base* base, evhttp* http, const http_options& opts);
+    }  // namespace detail
+
+    /** HTTP/1.1 server (libevent's evhttp) on one loop, dispatching requests to handlers by path.
+        A route is an exact path, or a prefix when its last character is '*' (a lone '*' matching
+        everything); exact routes win over prefixes, and longer prefixes over shorter ones.
+        Unmatched paths get 404, and a path routed only for other methods 405.
+
+        Connections are kept alive and requests may be pipelined: evhttp reads the next request on a
+        connection only once the previous response is complete, so responses always leave in request
+        order, including those answered later from a kept `http_request`.
+
+        Created with `unevent_loop::make_http_server` (or one per loop with `loop_pool::serve_http`),
+        which runs `setup` on the loop thread before listening so that no request can arrive ahead
+        of the routes. Handlers run on the loop thread; `route` may be called from any thread.
+     */
+    template <typename Loop>
+    class http_server {
+      public:
+        using handler = std::function<void(http_request)>;
+
+      private:
+        struct target {
+            uint32_t methods;
+            std::shared_ptr<handler> f;
+        };
+
+        using target_list = std::vector<target>;
+
+        std::weak_ptr<Loop> loop;
+        const std::atomic<trace_buffer*>& trace;
+        std::unique_ptr<evhttp, void (*)(evhttp*)> http{nullptr, ::evhttp_free};
+        uint16_t bound_port{0};
+
+        std::map<std::string, target_list, std::less<>> exact;
+        // longest first
+        std::vector<std::pair<std::string, target_list>> prefixes;
+
+        const target_list* match(std::string_view path) const {
+            if (auto it = exact.find(path); it != exact.end()) {
+                return &it->second;
+            }
+            for (const auto& [p, t] : prefixes) {
+                if (path.starts_with(p)) {
+                    return &t;
+                }
+            }
+            return nullptr;
+        }
+
+        static void on_request(evhttp_request* r, void* arg) {
+            auto& self = *static_cast<http_server*>(arg);
+            detail::io_trace_scope traced{self.trace, "http"};
+            http_request req{r};
+
+            const auto* targets = self.match(req.path());
+            if (not targets) {
+                req.reply(HTTP_NOTFOUND);
+                return;
+            }
+
+            auto m = static_cast<uint32_t>(req.method());
+            for (const auto& t : *targets) {
+                if (t.methods & m) {
+                    // keep the handler alive even if it replaces its own route
+                    auto f = t.f;
+                    try {
+                        (*f)(std::move(req));
+                    } catch (const std::exception& e) {
+                        unlog::critical(Loop::log, "HTTP handler caught exception: {}", e.what());
+                    }
+                    return;
+                }
+            }
+
+            req.reply(HTTP_BADMETHOD);
+        }
+
+        void add_route(std::string path, uint32_t methods, handler h) {
+            auto f = std::make_shared<handler>(std::move(h));
+
+            if (not path.empty() and path.back() == '*') {
+                path.pop_back();
+                auto it = std::ranges::find(prefixes, path, &std::pair<std::string, target_list>::first);
+                if (it == prefixes.end()) {
+                    auto pos = std::ranges::find_if(
+                            prefixes, [&](const auto& p) { return p.first.size() < path.size(); });
+                    it = prefixes.emplace(pos, std::move(path), target_list{});
+                }
+                set_target(it->second, methods, std::move(f));
+            }
+            else {
+                set_target(exact[std::move(path)], methods, std::move(f));
+            }
+        }
+
+        // A later route for the same path takes over the methods it names from earlier ones
+        static void set_target(target_list& targets, uint32_t methods, std::shared_ptr<handler> f) {
+            for (auto& t : targets) {
+                t.methods &= ~methods;
+            }
+            std::erase_if(targets, [](const target& t) { return t.methods == 0; });
+            targets.push_back({methods, std::move(f)});
+        }
+
+      public:
+        http_server(Loop& l, const http_options& opts, const std::function<void(http_server&)>& setup) :
+                loop{l.weak_from_this()}, trace{l.active_trace} {
+            http.reset(evhttp_new(l.loop()));
+            if (not http) {
+                throw std::runtime_error{"Failed to create http server"};
+            }
+            evhttp_set_gencb(http.get(), &http_server::on_request, this);
+
+            if (setup) {
+                setup(*this);
+            }
+
+            bound_port = detail::http_listen(l.loop(), http.get(), opts);
+        }
+
+        ~http_server() {
+            detail::release_on_loop(loop, [this] { http.reset(); }, [this] { (void)http.release(); });
+        }
+
+        http_server(const http_server&) = delete;
+        http_server& operator=(const http_server&) = delete;
+
+        uint16_t port() const noexcept { return bound_port; }
+
+        /** Routes requests for `path` with any of `methods` (all methods when empty) to `h`,
+            replacing whatever previously handled those methods there.
+         */
+        void route(std::string path, handler h, std::initializer_list<evhttp_cmd_type> methods = {}) {
+            uint32_t mask{0};
+            for (auto m : methods) {
+                mask |= static_cast<uint32_t>(m);
+            }
+            if (mask == 0) {
+                mask = ~uint32_t{0};
+            }
+
+            auto l = loop.lock();
+            if (l and not l->in_event_loop()) {
+                l->call_get([&] { add_route(std::move(path), mask, std::move(h)); });
+            }
+            else {
+                add_route(std::move(path), mask, std::move(h));
+            }
+        }
+
+        evhttp* native() const noexcept { return http.get(); }
+    };
+}  // namespace un::event
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+namespace un::event {
+    /** Single-loop shared ownership: like std::shared_ptr, but the reference count is a plain
+        integer living next to the object in one allocation, so copies cost no locked instructions
+        and no cache-line bouncing. Every copy, reset and destruction of a non-empty pointer must
+        happen on the owning loop's thread (asserted in debug builds); moves are free to cross
+        threads. Create with `unevent_loop::make_local`, and use `unevent_loop::share` to convert to
+        a std::shared_ptr that may be handed to other threads.
+
+        There is no weak_ptr counterpart and no aliasing constructor; anything needing those
+        should use the loop's `make_shared` instead.
+     */
+    template <typename T>
+    class local_ptr {
+        template <auto&>
+        friend class unevent_loop;
+
+        struct block {
+            T value;
+            uint32_t refs{1};
+#ifndef NDEBUG
+            std::thread::id owner;
+#endif
+
+            template <typename... Args>
+            explicit block([[maybe_unused]] std::thread::id _owner, Args&&... args) :
+                    value{std::forward<Args>(args)...}
+#ifndef NDEBUG
+                    ,
+                    owner{_owner}
+#endif
+            {
+            }
+        };
+
+        block* b{nullptr};
+
+        explicit local_ptr(block* _b) noexcept : b{_b} {}
+
+        void check_thread() const noexcept {
+#ifndef NDEBUG
+            assert(std::this_thread::get_id() == b->owner && "local_ptr used off its owning loop thread");
+#endif
+        }
+
+        template <typename... Args>
+        static local_ptr make(std::thread::id owner, Args&&... args) {
+            return local_ptr{new block{owner, std::forward<Args>(args)...}};
+        }
+
+        // Drops the reference without the thread check, for when the owning loop no longer exists
+        void release_orphaned() noexcept {
+            if (b and --b->refs == 0) {
+                delete b;
+            }
+            b = nullptr;
+        }
+
+      public:
+        using element_type = T;
+
+        local_ptr() noexcept = default;
+
+        local_ptr(const local_ptr& p) noexcept : b{p.b} {
+            if (b) {
+                check_thread();
+                ++b->refs;
+            }
+        }
+
+        local_ptr(local_ptr&& p) noexcept : b{std::exchange(p.b, nullptr)} {}
+
+        local_ptr& operator=(const local_ptr& p) noexcept {
+            local_ptr{p}.swap(*this);
+            return *this;
+        }
+
+        local_ptr& operator=(local_ptr&& p) noexcept {
+            local_ptr{std::move(p)}.swap(*this);
+            return *this;
+        }
+
+        ~local_ptr() { reset(); }
+
+        void reset() noexcept {
+            if (b) {
+                check_thread();
+                if (--b->refs == 0) {
+                    delete b;
+                }
+                b = nullptr;
+            }
+        }
+
+        void swap(local_ptr& p) noexcept { std::swap(b, p.b); }
+
+        T* get() const noexcept { return b ? &b->value : nullptr; }
+        T& operator*() const noexcept { return b->value; }
+        T* operator->() const noexcept { return &b->value; }
+
+        explicit operator bool() const noexcept { return b != nullptr; }
+
+        uint32_t use_count() const noexcept { return b ? b->refs : 0; }
+
+        friend bool operator==(const local_ptr& l, const local_ptr& r) noexcept { return l.b == r.b; }
+    };
+}  // namespace un::event
@@ -1,5 +1,16 @@
 #pragma once
 
+#include "blocking.hpp"
+#include "channel.hpp"
+#include "clock.hpp"
+#include "future.hpp"
+#include "local_ptr.hpp"
+#include "metrics.hpp"
+#include "options.hpp"
+#include "pool.hpp"
+#include "ticker_group.hpp"
+#include "trace.hpp"
+#include "transfer.hpp"
 #include "utils.hpp"
 
 extern "C" {
@@ -9,11 +20,18 @@ extern "C" {
 
 #include <atomic>
 #include <cstdint>
+#include <expected>
+#include <filesystem>
 #include <future>
 #include <list>
+#include <map>
 #include <memory>
+#include <optional>
 #include <queue>
+#include <source_location>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 namespace un::event {
     namespace deleters {
@@ -30,12 +48,61 @@ namespace un::event {
         struct test_helper;
     }  // namespace test
 
+    // Features built on the loop, each defined in its own header; include those you use
+    template <typename Loop>
+    class signal_set;
+    template <typename Loop>
+    class signal_watcher;
+    template <typename Loop>
+    class stream;
+    template <typename Loop>
+    class rate_limit_group;
+    template <typename Loop>
+    class connection_pool;
+    template <typename Loop>
+    class http_server;
+    template <typename Loop>
+    class dns_resolver;
+    template <typename Loop>
+    class shm_reader;
+    struct rate_limit;
+    struct connection_pool_options;
+    struct dns_options;
+    struct http_options;
+    class shm_channel;
+
     namespace detail {
         struct event_base* try_make_et_evbase();
+        // from signal.hpp: signals are kept off the loop thread even if this loop watches none
+        void block_signal(int signo);
+        void block_watched_signals();
+
+        /** A unit of loop work whose storage is owned by the poster (sender operation states): queued
+            by linking it into the loop's intrusive list, with no allocation or type erasure. `run` is
+            invoked once on the loop thread with `cancelled` false, or with `cancelled` true if the loop
+            shuts down before getting to it. The job may be destroyed by its own `run`.
+         */
+        struct intrusive_job {
+            intrusive_job* next{nullptr};
+            void (*run)(intrusive_job*, bool cancelled) noexcept;
+        };
     }  // namespace detail
 
     using job_hook = std::function<void()>;
 
+    struct queued_job {
+        job_hook f;
+        std::source_location site{};
+        std::source_location parent{};
+#if UNEVENT_METRICS
+        std::chrono::steady_clock::time_point posted{detail::get_time()};
+#endif
+
+        template <std::invocable Callable>
+        queued_job(Callable&& c, std::source_location _site = {}, std::source_location _parent = {}) :
+                f{std::forward<Callable>(c)}, site{_site}, parent{_parent} {}
+    };
+
 #if UNEVENT_EMBEDDED
     using job_allocator = allocazam::allocazam_std_allocator<
             job_hook,
@@ -56,6 +123,27 @@ namespace un::event {
 
     using caller_id_t = uint16_t;
 
+    /** What a fixed-rate ticker does when its callback (or the loop) overruns one or more ticks:
+            - skip : run the late tick once, then realign to the next future deadline on the grid
+            - catch_up : run one callback per missed tick, back to back, until back on schedule
+        Either way a callback taking a `uint64_t` receives the number of whole periods the current
+        tick is late: the ticks skipped for `skip`, the backlog still to run for `catch_up`.
+     */
+    enum class tick_policy : uint8_t { skip, catch_up };
+
+    enum class shutdown_policy : uint8_t {
+        drain,   // keep running queued jobs and one-shot timers due by the deadline, until idle
+        cancel,  // drop everything still pending immediately
+    };
+
+    // Work a `shutdown` discarded; all zero after a complete drain
+    struct shutdown_report {
+        size_t jobs_dropped{0};    // queued call_soon/call_async jobs and posted operations never run
+        size_t timers_dropped{0};  // call_later timers that never fired
+        size_t posts_rejected{0};  // posts from other threads refused once shutdown began
+        bool timed_out{false};     // the deadline passed before the loop went idle
+    };
+
     template <auto& C>
     class unevent_loop final : public std::enable_shared_from_this<unevent_loop<C>> {
         using ev_channel_type = std::remove_cvref_t<decltype(C)>;
@@ -63,24 +151,82 @@ namespace un::event {
 
         static constexpr auto& log = C;
 
-        unevent_loop() : ev_loop{detail::try_make_et_evbase(), ::event_base_free} {
+        template <typename>
+        friend class un::event::ticker_group;
+        template <typename, typename, channel_mode>
+        friend class un::event::channel;
+        template <typename>
+        friend class un::event::signal_set;
+        template <typename>
+        friend class un::event::stream;
+        template <typename>
+        friend class un::event::connection_pool;
+        template <typename>
+        friend class un::event::http_server;
+        template <typename>
+        friend class un::event::dns_resolver;
+        template <typename>
+        friend class un::event::shm_reader;
+
+        explicit unevent_loop(loop_options _opts) :
+                opts{std::move(_opts)},
+                ev_loop{detail::try_make_et_evbase(), ::event_base_free},
+                slow_threshold{opts.slow_callback_threshold} {
             unlog::trace(log, "Beginning loop context creation with new ev loop thread");
 
             unlog::debug(log, "Started libevent loop with backend {}", event_base_get_method(ev_loop.get()));
 
             setup_job_waker();
 
+            if (opts.clock) {
+                opts.clock->attach([this](std::chrono::steady_clock::time_point t) {
+                    call_get([&] { run_timers_until(t); });
+                });
+            }
+
             std::promise<void> p;
 
             loop_thread = std::thread{[this, &p]() mutable {
+                detail::block_watched_signals();
+
+                try {
+                    detail::apply_thread_options(opts.thread);
+                } catch (...) {
+                    p.set_exception(std::current_exception());
+                    return;
+                }
+
                 unlog::debug(log, "Starting event loop run");
                 p.set_value();
-                event_base_loop(ev_loop.get(), EVLOOP_NO_EXIT_ON_EMPTY);
+
+                if (opts.spin_budget > 0us) {
+                    run_spinning();
+                }
+                else {
+                    event_base_loop(ev_loop.get(), EVLOOP_NO_EXIT_ON_EMPTY);
+                }
+
+                // the loop was destroyed by one of its own callbacks: `this` is gone, only its base is left
+                if (orphaned_base) {
+                    event_base_free(std::exchange(orphaned_base, nullptr));
+                    return;
+                }
+
                 unlog::debug(log, "Event loop run returned, thread finished");
             }};
 
             loop_thread_id = loop_thread.get_id();
-            p.get_future().get();
+
+            try {
+                p.get_future().get();
+            } catch (const std::exception& e) {
+                unlog::critical(log, "Failed to apply loop thread options: {}", e.what());
+                loop_thread.join();
+                if (opts.clock) {
+                    opts.clock->detach();
+                }
+                throw;
+            }
 
             running.store(true);
             unlog::info(log, "loop is started");
@@ -92,21 +238,60 @@ namespace un::event {
         unevent_loop& operator=(unevent_loop) = delete;
 
       public:
-        [[nodiscard]] static std::shared_ptr<unevent_loop> make() {
-            return std::shared_ptr<unevent_loop>{new unevent_loop{}};
+        [[nodiscard]] static std::shared_ptr<unevent_loop> make(loop_options opts = {}) {
+            auto l = std::shared_ptr<unevent_loop>{new unevent_loop{std::move(opts)}};
+            l->call_get([w = std::weak_ptr<const void>{l}] { detail::thread_loop = w; });
+            return l;
         }
 
         ~unevent_loop() {
             unlog::info(log, "Shutting down loop...");
 
-            call_get([this]() { shutdown(); });
+            {
+                std::lock_guard lock{handoff->mutex};
+                handoff->owner = nullptr;
+            }
+
+            if (opts.clock) {
+                opts.clock->detach();
+            }
+
+            shutdown(detail::get_time(), shutdown_policy::cancel);
 
             stop_thread();
 
+            // nothing will run these now; complete them as cancelled so their owners are released
+            for (auto* j = std::exchange(intrusive_head, nullptr); j;) {
+                auto* next = j->next;
+                j->run(j, true);
+                j = next;
+            }
+            stop_tracked();
+            transfers.cancel_all();
+
+            // watchers still held elsewhere must not reach back into this loop when they are destroyed,
+            // and their events are freed now, while the base they belong to still exists
+            for (auto& [id, list] : tickers) {
+                for (auto& t : list) {
+                    if (auto tick = t.lock()) {
+                        tick->owner = nullptr;
+                        tick->ev.reset();
+                    }
+                }
+            }
+
             job_waker.reset();
+            // destroyed by one of its own callbacks: the thread is still inside the base, so it frees it on its way out
+            if (in_event_loop()) {
+                orphaned_base = ev_loop.release();
+            }
             unlog::info(log, "Loop shutdown complete");
         }
 
+        struct ev_watcher;
+        // timers of a loop on a `manual_clock`, by deadline; equal deadlines keep the order they were added in
+        using timer_heap = std::multimap<std::chrono::steady_clock::time_point, ev_watcher*>;
+
         struct ev_watcher {
             friend class unevent_loop;
             friend struct loop_callbacks;
@@ -115,35 +300,73 @@ namespace un::event {
             event_ptr ev;
             timeval interval;
             std::function<void()> f;
+            unevent_loop* owner{nullptr};
+            std::source_location site{};
+            std::chrono::microseconds period{};
+            std::atomic<std::chrono::steady_clock::time_point> deadline{};
+            bool persistent{false};
+            // fixed-rate tickers re-arm against absolute deadlines rather than relying on EV_PERSIST
+            std::optional<tick_policy> fixed_rate{};
+            uint64_t missed{0};
+            // entry in the owner's `virtual_timers` while armed on a manual clock; `ev` is unused then
+            std::optional<typename timer_heap::iterator> slot{};
+
+            bool virtual_time() const noexcept { return owner and owner->opts.clock; }
+
+            std::chrono::steady_clock::time_point current_time() const {
+                return owner ? owner->now() : detail::get_time();
+            }
+
+            static void on_timer(evutil_socket_t, short, void* s) {
+                auto* self = reinterpret_cast<unevent_loop::ev_watcher*>(s);
+                if (not self->f) {
+                    unlog::critical(log, "Ticker does not have a callback to execute!");
+                    return;
+                }
+#if UNEVENT_METRICS
+                self->record_fire();
+#endif
+                // re-arm before running the callback, so that it may stop or destroy its watcher
+                if (self->fixed_rate) {
+                    self->rearm_fixed();
+                }
+
+                // one-shot callbacks destroy their own watcher, so only copies are used after f()
+                auto* owner = self->owner;
+                auto site = self->site;
+                auto started = owner ? owner->begin_callback(site) : std::chrono::steady_clock::time_point{};
+
+                try {
+                    // execute callback
+                    self->f();
+                } catch (const std::exception& e) {
+                    unlog::critical(log, "Ticker caught exception: {}", e.what());
+                }
+
+                if (owner and not orphaned_base) {
+                    owner->end_callback(callback_kind::timer, started, site, {});
+                }
+            }
 
             void init_event(
                     ::event_base* _loop,
                     std::chrono::microseconds _t,
                     std::function<void()> task,
                     bool one_off = false,
-                    bool start_immediately = true) {
+                    bool start_immediately = true,
+                    std::source_location _site = {},
+                    std::optional<tick_policy> _fixed_rate = std::nullopt) {
                 f = std::move(task);
+                site = _site;
+                fixed_rate = _fixed_rate;
 
                 interval = loop_time_to_timeval(_t);
+                persistent = not one_off and not fixed_rate;
+                period = _t;
 
-                ev.reset(event_new(
-                        _loop,
-                        -1,
-                        one_off ? 0 : EV_PERSIST,
-                        [](evutil_socket_t, short, void* s) {
-                            try {
-                                auto* self = reinterpret_cast<unevent_loop::ev_watcher*>(s);
-                                if (not self->f) {
-                                    unlog::critical(log, "Ticker does not have a callback to execute!");
-                                    return;
-                                }
-                                // execute callback
-                                self->f();
-                            } catch (const std::exception& e) {
-                                unlog::critical(log, "Ticker caught exception: {}", e.what());
-                            }
-                        },
-                        this));
+                if (not virtual_time()) {
+                    ev.reset(event_new(_loop, -1, persistent ? EV_PERSIST : 0, &ev_watcher::on_timer, this));
+                }
 
                 if ((one_off or start_immediately) and not start()) {
                     unlog::critical(log, "Failed to immediately start one-off event!");
@@ -152,8 +375,63 @@ namespace un::event {
 
             ev_watcher() = default;
 
+#if UNEVENT_METRICS
+            // mirrors libevent's EV_PERSIST rescheduling: the next deadline is relative to the one that
+            // just fired, unless that is already in the past
+            void record_fire() {
+                auto now = current_time();
+                auto due = deadline.load(std::memory_order_relaxed);
+
+                if (owner) {
+                    auto& m = owner->metrics_state;
+                    loop_metrics::bump(m.timer_fires);
+                    m.timer_lag_ns.record(loop_metrics::to_ns(now - due));
+                }
+
+                if (persistent) {
+                    auto next = due + period;
+                    deadline.store(next < now ? now + period : next, std::memory_order_relaxed);
+                }
+            }
+#endif
+
+            void rearm_fixed() {
+                auto now = current_time();
+                auto due = deadline.load(std::memory_order_relaxed);
+
+                missed = now > due ? static_cast<uint64_t>((now - due) / period) : 0;
+
+                auto next = due + period;
+                if (*fixed_rate == tick_policy::skip) {
+                    next += static_cast<int64_t>(missed) * period;
+                }
+                deadline.store(next, std::memory_order_relaxed);
+
+                if (virtual_time()) {
+                    owner->schedule_virtual(*this, next);
+                    return;
+                }
+
+                // round up: firing even a microsecond early would look like a tick with no lag
+                auto delay = next > now ? std::chrono::ceil<std::chrono::microseconds>(next - now)
+                                        : std::chrono::microseconds{0};
+                auto tv = loop_time_to_timeval(delay);
+
+                if (event_add(ev.get(), &tv) != 0) {
+                    unlog::critical(log, "EventHandler failed to re-arm fixed-rate event!");
+                }
+            }
+
+            // Armed, and not yet fired if a one-shot
+            bool pending() const {
+                return slot.has_value() or (ev and event_pending(ev.get(), EV_TIMEOUT, nullptr));
+            }
+
           public:
             ~ev_watcher() {
+                if (virtual_time()) {
+                    owner->cancel_virtual(*this);
+                }
                 ev.reset();
                 f = nullptr;
             }
@@ -164,6 +442,14 @@ namespace un::event {
                     - false: event is already running, or failed to start the event
              */
             bool start() {
+                auto due = current_time() + period;
+                deadline.store(due, std::memory_order_relaxed);
+
+                if (virtual_time()) {
+                    owner->schedule_virtual(*this, due);
+                    return true;
+                }
+
                 if (event_add(ev.get(), &interval) != 0) {
                     unlog::critical(log, "EventHandler failed to start repeating event!");
                     return false;
@@ -178,6 +464,10 @@ namespace un::event {
                     - false: event is already stopped, or failed to stop the event
              */
             bool stop() {
+                if (virtual_time()) {
+                    owner->cancel_virtual(*this);
+                }
+
                 if (ev && event_del(ev.get()) != 0) {
                     unlog::critical(log, "EventHandler failed to pause repeating event!");
                     return false;
@@ -188,54 +478,333 @@ namespace un::event {
         };
 
       private:
+        const loop_options opts;
         std::atomic<bool> running{false};
+        std::atomic<bool> stopping{false};
+        std::atomic<bool> spinning{false};
+        std::atomic<bool> jobs_pending{false};
         std::unique_ptr<::event_base, void (*)(struct ::event_base*)> ev_loop;
+        // Base of a loop destroyed on its own thread, left for that thread to free once it unwinds
+        static inline thread_local ::event_base* orphaned_base{nullptr};
         std::thread loop_thread;
         std::thread::id loop_thread_id;
 
         event_ptr job_waker;
-        std::deque<job_hook> job_queue;
+        std::deque<queued_job> job_queue;
+        // caller-owned jobs from `post`, FIFO among themselves; guarded by job_queue_mutex
+        detail::intrusive_job* intrusive_head{nullptr};
+        detail::intrusive_job** intrusive_tail{&intrusive_head};
         std::mutex job_queue_mutex;
 
+        // operations armed on the base by their owners, stopped at shutdown; loop thread only
+        detail::tracked_op* tracked_head{nullptr};
+        // running `send_file` transfers, cancelled by the destructor
+        transfer_registry transfers;
+
+        // the batch process_job_queue is working through; loop thread only
+        std::deque<queued_job>* batch_remaining{nullptr};
+        detail::intrusive_job* posted_batch{nullptr};
+        // jobs process_job_queue abandoned once `running` went false, reported by close()
+        size_t abandoned_jobs{0};
+
+        enum class loop_phase : uint8_t { open, draining, closed };
+        std::atomic<loop_phase> phase{loop_phase::open};
+        std::atomic<size_t> rejected_posts{0};
+
+        // call_blocking results waiting for the loop, handed over in one queued job per batch. Helper
+        // threads reach it through their own reference rather than the loop's, so none of them ever
+        // owns the loop; the destructor clears `owner` before tearing anything down.
+        struct blocking_handoff {
+            unevent_loop* owner;
+            std::mutex mutex{};
+            std::vector<std::move_only_function<void()>> done{};
+        };
+        const std::shared_ptr<blocking_handoff> handoff{std::make_shared<blocking_handoff>(this)};
+        // call_blocking work not yet handed back; keeps a draining shutdown waiting
+        std::atomic<size_t> blocking_inflight{0};
+
+        // slow-callback watchdog; zero when disabled
+        const std::chrono::steady_clock::duration slow_threshold;
+        // site of the callback currently executing on the loop thread
+        std::source_location running_site{};
+
+        // allocated once on the first start_tracing(); `active_trace` is null while tracing is off
+        std::unique_ptr<trace_buffer> trace_buf;
+        std::atomic<trace_buffer*> active_trace{nullptr};
+        mutable std::mutex trace_mutex;
+
+        // armed timers when `opts.clock` is set, fired by `run_timers_until`; loop thread only, which
+        // `schedule_virtual` and `cancel_virtual` hop to
+        timer_heap virtual_timers;
+
         std::unordered_map<caller_id_t, std::list<std::weak_ptr<ev_watcher>>> tickers;
+        size_t tracked_tickers{0};
+        size_t sweep_threshold{64};
+
+        // shared with every pool_allocator so that memory outlives the loop while references remain
+        std::shared_ptr<object_pool> pool{std::make_shared<object_pool>()};
+        // created by the first on_signal; loop thread only
+        std::shared_ptr<signal_set<unevent_loop>> signals;
+
+#if UNEVENT_METRICS
+        loop_metrics metrics_state;
+#endif
+
+        /** Allocator handed to std::allocate_shared by `make_shared`. Objects are constructed with
+            brace initialization (matching `new T{...}`), and destroyed on the loop thread: a release
+            from any other thread waits on `call_get` for the destructor to run, exactly as
+            `loop_deleter` does.
+         */
+        template <typename U>
+        struct pool_allocator {
+            using value_type = U;
+
+            template <typename V>
+            struct rebind {
+                using other = pool_allocator<V>;
+            };
+
+            std::weak_ptr<unevent_loop> owner;
+            std::shared_ptr<object_pool> pool;
+            // compared directly, so that choosing a free list never touches the loop's control block
+            std::thread::id owner_thread;
+
+            pool_allocator(
+                    std::weak_ptr<unevent_loop> _owner,
+                    std::shared_ptr<object_pool> _pool,
+                    std::thread::id _thread) noexcept :
+                    owner{std::move(_owner)}, pool{std::move(_pool)}, owner_thread{_thread} {}
+
+            template <typename V>
+            pool_allocator(const pool_allocator<V>& a) noexcept :
+                    owner{a.owner}, pool{a.pool}, owner_thread{a.owner_thread} {}
+
+            bool on_owner() const noexcept { return std::this_thread::get_id() == owner_thread; }
+
+            U* allocate(size_t n) {
+                return static_cast<U*>(pool->allocate(n * sizeof(U), alignof(U), on_owner()));
+            }
+
+            void deallocate(U* p, size_t n) noexcept { pool->deallocate(p, n * sizeof(U), alignof(U), on_owner()); }
+
+            template <typename V, typename... Args>
+            void construct(V* p, Args&&... args) {
+                ::new (static_cast<void*>(p)) V{std::forward<Args>(args)...};
+            }
+
+            template <typename V>
+            void destroy(V* p) {
+                auto self = owner.lock();
+                if (self and not self->in_event_loop()) {
+                    self->call_get([p] { p->~V(); });
+                }
+                else {
+                    p->~V();
+                }
+            }
+
+            template <typename V>
+            bool operator==(const pool_allocator<V>& a) const noexcept {
+                return pool == a.pool;
+            }
+        };
 
       public:
         ::event_base* loop() const noexcept { return ev_loop.get(); }
 
+        const loop_options& options() const noexcept { return opts; }
+
+        /** Starts recording wakeups, job queue drains and job/timer callbacks into this loop's trace
+            ring, allocating it (with `trace_capacity` records) on first use. When tracing is off each
+            instrumentation point costs a single atomic load.
+         */
+        void start_tracing() {
+            std::lock_guard lock{trace_mutex};
+            if (not trace_buf) {
+                trace_buf = std::make_unique<trace_buffer>(opts.trace_capacity);
+            }
+            active_trace.store(trace_buf.get(), std::memory_order_release);
+        }
+
+        void stop_tracing() { active_trace.store(nullptr, std::memory_order_release); }
+
+        // Dumps the retained records as Chrome trace event JSON, viewable offline in ui.perfetto.dev
+        std::string trace_json() const {
+            std::lock_guard lock{trace_mutex};
+            return trace_buf ? trace_buf->to_chrome_json() : std::string{R"({"displayTimeUnit":"ns","traceEvents":[]})"};
+        }
+
+#if UNEVENT_METRICS
+        // Point-in-time copy of this loop's counters and histograms; safe to call from any thread
+        metrics_snapshot metrics() const { return metrics_state.snapshot(); }
+#endif
+
         template <std::invocable<> Callable>
-        void call(Callable&& f) {
+        void call(Callable&& f, std::source_location loc = std::source_location::current()) {
             if (in_event_loop()) {
                 f();
             }
             else {
-                call_soon(std::forward<Callable>(f));
+                call_soon(std::forward<Callable>(f), loc);
             }
         }
 
+        // Blocks until `f` has run on the loop. Never rejected while shutting down; once the loop has
+        // shut down (see `shutdown`), or a cancelling shutdown drops the queued call, `f` runs
+        // directly on the calling thread instead.
         template <typename Callable, typename Ret = decltype(std::declval<Callable>()())>
-        Ret call_get(Callable&& f) {
-            if (in_event_loop()) {
+        Ret call_get(Callable&& f, std::source_location loc = std::source_location::current()) {
+            if (in_event_loop() or phase.load(std::memory_order_acquire) == loop_phase::closed) {
                 return f();
             }
 
-            std::promise<Ret> prom;
-            auto fut = prom.get_future();
+            // the job owns the promise, so a cancelling shutdown that drops it unrun breaks the promise
+            auto prom = std::make_shared<std::promise<Ret>>();
+            auto fut = prom->get_future();
 
-            call_soon([&f, &prom] {
+            enqueue([&f, prom = std::move(prom)] {
                 try {
                     if constexpr (!std::is_void_v<Ret>) {
-                        prom.set_value(f());
+                        prom->set_value(f());
                     }
                     else {
                         f();
-                        prom.set_value();
+                        prom->set_value();
                     }
                 } catch (...) {
-                    prom.set_exception(std::current_exception());
+                    prom->set_exception(std::current_exception());
                 }
-            });
+            }, loc, true);
+
+            try {
+                return fut.get();
+            } catch (const std::future_error& e) {
+                if (e.code() != std::future_errc::broken_promise) {
+                    throw;
+                }
+            }
+            // dropped by the shutdown that closed the loop: run it here, as on any closed loop
+            return f();
+        }
+
+        /** Non-blocking counterpart of `call_get`: queues `f` like `call_soon` and returns a
+            `loop_future` for its result (or exception). Consume it with `then(loop, g)`, which posts `g`
+            to `loop` once the result is in, so another loop can request work here without stalling.
+            The future's shared state is a single allocation.
+        */
+        template <std::invocable Callable>
+        [[nodiscard]] auto call_async(Callable&& f, std::source_location loc = std::source_location::current()) {
+            using Ret = std::invoke_result_t<Callable>;
+
+            // a refused post destroys the job at once and a shutdown dropping it destroys it later;
+            // either way its producer fails the future
+            auto st = std::make_shared<detail::future_state<Ret>>();
+            call_soon(
+                    [p = detail::future_producer<Ret>{st}, fn = std::forward<Callable>(f)]() mutable { p->fulfil(fn); },
+                    loc);
+
+            return loop_future<Ret>{std::move(st)};
+        }
 
-            return fut.get();
+        /** Runs `f` on a helper thread of the loop's `blocking_pool` (`loop_options::blocking`, else
+            `blocking_pool::shared()`), then calls `done(blocking_result<R>)` on this loop with what
+            `f` returned or threw. Completions finishing close together reach the loop through a
+            single queued job. Returns false, without running `f`, if the loop is shutting down;
+            work already handed off still completes during a draining shutdown, but its `done` is
+            dropped once the loop has closed or been destroyed.
+        */
+        template <std::invocable Callable, typename Done>
+        bool call_blocking(Callable f, Done done, std::source_location loc = std::source_location::current()) {
+            using Ret = std::invoke_result_t<Callable>;
+
+            if (not accepting(false)) {
+                return false;
+            }
+
+            blocking_inflight.fetch_add(1, std::memory_order_relaxed);
+            blocking_executor().submit(
+                    [h = handoff, f = std::move(f), done = std::move(done), loc]() mutable {
+                        auto r = [&]() -> blocking_result<Ret> {
+                            try {
+                                if constexpr (std::is_void_v<Ret>) {
+                                    f();
+                                    return {};
+                                }
+                                else {
+                                    return f();
+                                }
+                            } catch (...) {
+                                return std::unexpected{std::current_exception()};
+                            }
+                        }();
+
+                        complete_blocking(
+                                *h, [r = std::move(r), done = std::move(done)]() mutable { done(std::move(r)); }, loc);
+                    });
+
+            return true;
+        }
+
+        /** Streams `count` bytes (`file_transfer::to_end` for the rest of the file) of the file
+            `in_fd` from `offset` to the non-blocking socket `out_fd` without copying through user
+            space, calling `done(std::error_code, size_t bytes_sent)` on this loop when it ends. The
+            returned handle may be dropped; keep it to watch progress or cancel from the loop thread.
+            Transfers still running when the loop is destroyed complete as cancelled.
+        */
+        template <typename Done>
+        std::shared_ptr<file_transfer> send_file(
+                int out_fd,
+                int in_fd,
+                off_t offset,
+                size_t count,
+                Done done,
+                transfer_options topts = {},
+                std::source_location loc = std::source_location::current()) {
+            return call_get(
+                    [&] {
+                        return file_transfer::start(
+                                loop(),
+                                transfers,
+                                active_trace,
+                                out_fd,
+                                in_fd,
+                                offset,
+                                count,
+                                [d = std::move(done)](std::error_code ec, size_t n) mutable {
+                                    try {
+                                        d(ec, n);
+                                    } catch (const std::exception& e) {
+                                        unlog::critical(log, "File transfer completion threw exception: {}", e.what());
+                                    }
+                                },
+                                topts);
+                    },
+                    loc);
+        }
+
+        // Reads the whole of `path` off the loop; `done(blocking_result<std::string>)`
+        template <typename Done>
+        bool read_file(
+                std::filesystem::path path, Done done, std::source_location loc = std::source_location::current()) {
+            return call_blocking(
+                    [p = std::move(path)] { return detail::read_whole_file(p); }, std::move(done), loc);
+        }
+
+        // Writes `data` to `path` off the loop, replacing or appending to it and optionally fsyncing
+        // before `done(blocking_result<void>)` is called
+        template <typename Done>
+        bool write_file(
+                std::filesystem::path path,
+                std::string data,
+                Done done,
+                file_write_options wopts = {},
+                std::source_location loc = std::source_location::current()) {
+            return call_blocking(
+                    [p = std::move(path), d = std::move(data), wopts] {
+                        detail::write_whole_file(p, d, wopts.append, wopts.sync);
+                    },
+                    std::move(done),
+                    loc);
         }
 
         /** This invocation of `call_every` will return an EventHandler object from which the
@@ -247,50 +816,396 @@ namespace un::event {
         */
         template <typename Callable>
         [[nodiscard]] std::shared_ptr<ev_watcher> call_every(
-                std::chrono::microseconds interval, Callable&& f, bool start_immediately = true) {
-            return _call_every(interval, std::forward<Callable>(f), unevent_loop::loop_id, start_immediately);
+                std::chrono::microseconds interval,
+                Callable&& f,
+                bool start_immediately = true,
+                std::source_location loc = std::source_location::current()) {
+            return _call_every(interval, std::forward<Callable>(f), unevent_loop::loop_id, start_immediately, loc);
         }
 
+        /** Fixed-rate variant of `call_every`: ticks are anchored to absolute deadlines (start time plus
+            a whole number of intervals) instead of being rescheduled relative to when the previous
+            callback ran, so a ticker whose callback takes variable time stays phase-locked. Overruns
+            are resolved according to `policy`.
+
+            The callable may take no arguments, or a `uint64_t` receiving the number of periods the
+            current tick is late (see `tick_policy`).
+        */
+        template <typename Callable>
+        [[nodiscard]] std::shared_ptr<ev_watcher> call_every_fixed(
+                std::chrono::microseconds interval,
+                Callable&& f,
+                tick_policy policy = tick_policy::skip,
+                bool start_immediately = true,
+                std::source_location loc = std::source_location::current()) {
+            auto h = make_handler(unevent_loop::loop_id);
+
+            std::function<void()> task;
+            if constexpr (std::invocable<Callable, uint64_t>) {
+                // the watcher owns `task`, so the raw pointer cannot dangle
+                task = [w = h.get(), cb = std::forward<Callable>(f)]() mutable { cb(w->missed); };
+            }
+            else {
+                static_assert(std::invocable<Callable>, "call_every_fixed callback must take () or (uint64_t)");
+                task = std::forward<Callable>(f);
+            }
+
+            h->init_event(loop(), interval, std::move(task), false, start_immediately, loc, policy);
+
+            return h;
+        }
+
+        using ticker_group = un::event::ticker_group<unevent_loop>;
+
+        /** Creates a group of tickers sharing `interval`: every member joined to the group rides one
+            underlying watcher, so N tickers at the same cadence cost one timer heap entry and one
+            wakeup per tick instead of N. The group's timer only runs while it has members.
+        */
+        [[nodiscard]] std::shared_ptr<ticker_group> make_ticker_group(
+                std::chrono::microseconds interval, std::source_location loc = std::source_location::current()) {
+            auto g = make_shared<ticker_group>(*this, interval, loc);
+            g->weak_self = g;
+            return g;
+        }
+
+        using stream = un::event::stream<unevent_loop>;
+        using rate_limit_group = un::event::rate_limit_group<unevent_loop>;
+
+        // Wraps the connected socket `fd`, which the stream then owns, in a stream on this loop
+        [[nodiscard]] std::shared_ptr<stream> make_stream(
+                evutil_socket_t fd, std::source_location loc = std::source_location::current()) {
+            return call_get([&] { return std::make_shared<stream>(*this, fd); }, loc);
+        }
+
+        /** Creates a token bucket that streams on this loop can `join` to share one aggregate limit.
+            Refilling is a single timer per group, not per member, so one group can shape any
+            number of connections.
+        */
+        [[nodiscard]] std::shared_ptr<rate_limit_group> make_rate_limit_group(
+                const rate_limit& limit, std::source_location loc = std::source_location::current()) {
+            return call_get([&] { return std::make_shared<rate_limit_group>(*this, limit); }, loc);
+        }
+
+        using dns_resolver = un::event::dns_resolver<unevent_loop>;
+
+        /** Creates an asynchronous resolver on this loop (see `dns_resolver`). Give resolvers on
+            several loops the same `dopts.cache` to share answers between them.
+        */
+        [[nodiscard]] std::shared_ptr<dns_resolver> make_resolver(
+                const dns_options& dopts = {}, std::source_location loc = std::source_location::current()) {
+            return call_get(
+                    [&] {
+                        auto r = make_shared<dns_resolver>(*this, dopts);
+                        r->weak_self = r;
+                        return r;
+                    },
+                    loc);
+        }
+
+        using connection_pool = un::event::connection_pool<unevent_loop>;
+
+        /** Creates a pool of outbound connections kept for reuse per endpoint (see `connection_pool`).
+            Idle connections are swept by a member of `ticker`, or of a group of the pool's own at
+            `sweep_interval` when none is given. Host names go through `resolver` when one is given.
+        */
+        [[nodiscard]] std::shared_ptr<connection_pool> make_connection_pool(
+                const connection_pool_options& popts = {},
+                std::shared_ptr<ticker_group> ticker = nullptr,
+                std::shared_ptr<dns_resolver> resolver = nullptr) {
+            auto p = make_shared<connection_pool>(*this, popts, std::move(ticker), std::move(resolver));
+            p->weak_self = p;
+            return p;
+        }
+
+        using http_server = un::event::http_server<unevent_loop>;
+
+        /** Starts an HTTP server on this loop listening as `hopts` says (see `http_server`). `setup`,
+            typically registering the routes, runs on the loop thread before the server starts
+            listening. Throws if the address cannot be bound.
+        */
+        [[nodiscard]] std::shared_ptr<http_server> make_http_server(
+                const http_options& hopts,
+                const std::function<void(http_server&)>& setup = nullptr,
+                std::source_location loc = std::source_location::current()) {
+            return call_get([&] { return std::make_shared<http_server>(*this, hopts, setup); }, loc);
+        }
+
+        using shm_reader = un::event::shm_reader<unevent_loop>;
+
+        /** Reads `ch` on this loop, calling `f` on the loop thread with each message in write order
+            (see `shm_reader`), at most `max_batch` per wakeup before other events get a turn.
+            Reading stops when the returned reader is destroyed.
+        */
+        [[nodiscard]] std::shared_ptr<shm_reader> make_shm_reader(
+                shm_channel&& ch,
+                std::function<void(std::string_view)> f,
+                size_t max_batch = 256,
+                std::source_location loc = std::source_location::current()) {
+            return call_get(
+                    [&] { return make_shared<shm_reader>(*this, std::move(ch), std::move(f), max_batch); }, loc);
+        }
+
+        using signal_watcher = un::event::signal_watcher<unevent_loop>;
+
+        /** Calls `f(count)` on the loop thread whenever `signo` arrives, `count` being the number of
+            deliveries since the last call (see `signal_set`); the handle unregisters on destruction.
+            Signals are read from a signalfd, never through a handler: the signal is blocked here,
+            on the loop thread and in threads uneventful starts later, but any other thread must
+            block it as well (see `block_signals`). Only one loop in the process may watch a given
+            signal; registering it on another throws std::logic_error.
+        */
+        [[nodiscard]] signal_watcher on_signal(
+                int signo, std::function<void(uint32_t)> f, std::source_location loc = std::source_location::current()) {
+            detail::block_signal(signo);
+
+            return call_get(
+                    [&] {
+                        if (not signals) {
+                            signals = std::make_shared<signal_set<unevent_loop>>(*this);
+                            signals->weak_self = signals;
+                        }
+                        return signals->add(signo, std::move(f), loc);
+                    },
+                    loc);
+        }
+
+        template <typename T, channel_mode Mode = channel_mode::mpsc>
+        using channel = un::event::channel<T, unevent_loop, Mode>;
+
+        /** Creates a bounded channel consumed by this loop: `handler` runs on the loop thread for every
+            message, in send order per producer. Senders on any thread (typically other loops) use
+            `try_send`/`try_emplace`, which fail rather than block when `capacity` messages are
+            already in flight. Use channel_mode::spsc when only one thread ever sends.
+        */
+        template <typename T, channel_mode Mode = channel_mode::mpsc>
+        [[nodiscard]] std::shared_ptr<channel<T, Mode>> make_channel(size_t capacity, std::function<void(T&&)> handler) {
+            return make_shared<channel<T, Mode>>(*this, capacity, std::move(handler));
+        }
+
+        // Returns false if the loop is shutting down and refused the timer
         template <std::invocable Callable>
-        void call_later(std::chrono::microseconds delay, Callable hook) {
+        bool call_later(
+                std::chrono::microseconds delay, Callable hook, std::source_location loc = std::source_location::current()) {
             if (in_event_loop()) {
-                add_oneshot_event(delay, std::move(hook));
+                if (phase.load(std::memory_order_acquire) == loop_phase::closed) {
+                    return false;
+                }
+                add_oneshot_event(delay, std::move(hook), loc);
+                return true;
             }
             else {
-                call_soon([this, func = std::move(hook), target_time = detail::get_time() + delay]() mutable {
-                    auto now = detail::get_time();
+                return call_soon(
+                        [this, func = std::move(hook), target_time = now() + delay, loc]() mutable {
+                            auto now = this->now();
 
-                    if (now >= target_time) {
-                        func();
-                    }
-                    else {
-                        add_oneshot_event(
-                                std::chrono::duration_cast<std::chrono::microseconds>(target_time - now),
-                                std::move(func));
-                    }
-                });
+                            if (now >= target_time) {
+                                func();
+                            }
+                            else {
+                                add_oneshot_event(
+                                        std::chrono::duration_cast<std::chrono::microseconds>(target_time - now),
+                                        std::move(func),
+                                        loc);
+                            }
+                        },
+                        loc);
             }
         }
 
+        // Returns false, without queueing `f`, if the loop is shutting down (see `shutdown`)
         template <std::invocable Callable>
-        void call_soon(Callable f) {
-            {
-                std::lock_guard lock{job_queue_mutex};
-                job_queue.emplace_back(std::move(f));
+        bool call_soon(Callable f, std::source_location loc = std::source_location::current()) {
+            return enqueue(std::move(f), loc, false);
+        }
+
+        /** Queues a caller-owned job (see `detail::intrusive_job`). Posted jobs run after the
+            `call_soon` jobs taken in the same queue pass; the caller must keep `j` alive until its
+            `run` has been invoked. Returns false, leaving `j` untouched, if the loop is shutting down.
+        */
+        bool post(detail::intrusive_job* j, std::source_location loc = std::source_location::current()) {
+            if (not accepting(false)) {
+                return false;
+            }
+
+            push_intrusive(j, loc);
+            return true;
+        }
+
+        /** Links `op`, which its owner has armed on this loop's base, so that a shutdown stops it (see
+            `detail::tracked_op`). Loop thread only; `untrack` it once it completes by itself.
+        */
+        void track(detail::tracked_op* op) noexcept { op->link(tracked_head); }
+
+        void untrack(detail::tracked_op* op) noexcept { op->unlink(tracked_head); }
+
+        /** Stops the loop accepting work and settles what is already pending, returning counts of
+            whatever was discarded. Safe to call once from any thread other than the loop's (the
+            `cancel` policy may also be used on the loop thread); later calls return an empty report.
+
+            With `drain`, posts from other threads are rejected from the start (`call_soon`,
+            `call_later` and `post` return false, `call_async` futures fail) while jobs already queued,
+            and any follow-up work they queue from the loop thread, keep running. Repeating tickers
+            stop immediately; one-shot timers due before `deadline` still fire, later ones are dropped.
+            The loop is considered drained once its job queue is empty and no one-shot timer is
+            pending; whatever remains at `deadline` is dropped. With `cancel`, everything pending is
+            dropped at once. Dropped `call_async` jobs fail their futures and dropped `call_get`
+            calls run on their waiting threads instead.
+
+            Afterwards the loop thread keeps servicing I/O until destruction, but runs no further jobs
+            or timers, and `call_get` executes on the calling thread. The destructor performs a
+            `cancel` shutdown if none was requested.
+        */
+        shutdown_report shutdown(
+                std::chrono::steady_clock::time_point deadline, shutdown_policy policy = shutdown_policy::drain) {
+            if (policy == shutdown_policy::drain and in_event_loop()) {
+                throw std::logic_error{"A draining shutdown cannot be waited for from the loop thread"};
+            }
+
+            auto expected = loop_phase::open;
+            if (not phase.compare_exchange_strong(expected, loop_phase::draining)) {
+                return {};
+            }
+
+            shutdown_report report{};
+            // the last drain probe, if the deadline passed before it ran
+            std::future<bool> pending;
+
+            if (policy == shutdown_policy::drain) {
+                unlog::debug(log, "Draining loop before shutdown...");
+
+                auto step = [&, first = true]() mutable {
+                    if (std::exchange(first, false)) {
+                        report.timers_dropped = begin_drain(deadline);
+                    }
+                    return drained();
+                };
+
+                for (;;) {
+                    auto prom = std::make_shared<std::promise<bool>>();
+                    pending = prom->get_future();
+                    enqueue([prom, &step] { prom->set_value(step()); }, std::source_location::current(), true);
+
+                    if (pending.wait_until(deadline) != std::future_status::ready) {
+                        report.timed_out = true;
+                        break;
+                    }
+                    if (pending.get()) {
+                        break;
+                    }
+
+                    auto now = detail::get_time();
+                    if (now >= deadline) {
+                        report.timed_out = true;
+                        break;
+                    }
+                    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(deadline - now, 1ms));
+                }
+            }
+
+            // abandons the rest of the batch in progress as soon as its current job returns
+            running.store(false, std::memory_order_release);
+
+            if (in_event_loop()) {
+                close(report);
+            }
+            else {
+                // queued as a posted job, which still runs once `running` is false
+                struct close_job : detail::intrusive_job {
+                    unevent_loop* self;
+                    shutdown_report* report;
+                    std::promise<void> done{};
+                };
+
+                close_job job{
+                        {.run =
+                                 [](detail::intrusive_job* j, bool) noexcept {
+                                     auto& c = static_cast<close_job&>(*j);
+                                     c.self->close(*c.report);
+                                     c.done.set_value();
+                                 }},
+                        this,
+                        &report};
+
+                push_intrusive(&job, std::source_location::current());
+                job.done.get_future().wait();
+            }
+
+            // a probe the loop never got to was counted with the dropped jobs
+            if (pending.valid()) {
+                try {
+                    pending.get();
+                } catch (const std::future_error&) {
+                    --report.jobs_dropped;
+                }
+            }
+
+            report.posts_rejected = rejected_posts.load(std::memory_order_relaxed);
+
+            if (report.jobs_dropped or report.timers_dropped or report.posts_rejected) {
+                unlog::info(
+                        log,
+                        "Loop shutdown dropped {} jobs and {} timers, rejected {} posts{}",
+                        report.jobs_dropped,
+                        report.timers_dropped,
+                        report.posts_rejected,
+                        report.timed_out ? " (deadline reached)" : "");
             }
 
-            event_active(job_waker.get(), 0, 0);
+            return report;
+        }
+
+        shutdown_report shutdown(std::chrono::milliseconds timeout, shutdown_policy policy = shutdown_policy::drain) {
+            return shutdown(detail::get_time() + timeout, policy);
         }
 
         bool in_event_loop() const noexcept { return std::this_thread::get_id() == loop_thread_id; }
 
+        // Time as this loop's timers see it: that of `loop_options::clock` if set, else steady_clock's
+        std::chrono::steady_clock::time_point now() const {
+            return opts.clock ? opts.clock->now() : detail::get_time();
+        }
+
         // Similar in concept to std::make_shared<T>, but it creates the shared pointer with a
         // custom deleter that dispatches actual object destruction to the network's event loop for
         // thread safety.
+        // The object and its control block share a single allocation from this loop's object pool,
+        // and the memory goes back to the pool's free lists once the last reference is gone.
         template <typename T, typename... Args>
         std::shared_ptr<T> make_shared(Args&&... args) {
-            auto* ptr = new T{std::forward<Args>(args)...};
-            return std::shared_ptr<T>{ptr, loop_deleter<T>()};
+            return std::allocate_shared<T>(
+                    pool_allocator<T>{this->weak_from_this(), pool, loop_thread_id}, std::forward<Args>(args)...);
+        }
+
+        // Creates a `local_ptr` owned by this loop: non-atomic shared ownership for objects that are
+        // only ever touched from the loop thread
+        template <typename T, typename... Args>
+        local_ptr<T> make_local(Args&&... args) {
+            return local_ptr<T>::make(loop_thread_id, std::forward<Args>(args)...);
+        }
+
+        // Converts a loop-local pointer into a std::shared_ptr that may be copied and released on any
+        // thread. The returned pointer holds one local reference, which is given back on the loop
+        // thread once the last std::shared_ptr copy goes away, even after the loop has shut down.
+        template <typename T>
+        std::shared_ptr<T> share(local_ptr<T> p) {
+            auto* raw = p.get();
+            auto weak_self = this->weak_from_this();
+            return std::shared_ptr<T>{raw, [weak_self, held = std::move(p)](T*) mutable {
+                                          auto self = weak_self.lock();
+                                          if (not self) {
+                                              held.release_orphaned();
+                                          }
+                                          else if (not self->in_event_loop()) {
+                                              // forced: a closed loop still discards its jobs on the loop thread
+                                              self->enqueue(
+                                                      [h = std::move(held)]() mutable { h.reset(); },
+                                                      std::source_location::current(),
+                                                      true);
+                                          }
+                                          else {
+                                              held.reset();
+                                          }
+                                      }};
         }
 
         // Similar to the above make_shared, but instead of forwarding arguments for the
@@ -333,8 +1248,15 @@ namespace un::event {
         void stop_thread() {
             unlog::debug(log, "Stopping loop thread...");
 
+            stopping.store(true);
             event_base_loopbreak(ev_loop.get());
 
+            // a spinning loop clears the break flag on re-entry to event_base_loop, so also leave it an
+            // active event to return on
+            if (opts.spin_budget > 0us) {
+                event_active(job_waker.get(), 0, 0);
+            }
+
             if (loop_thread.joinable()) {
                 in_event_loop() ? loop_thread.detach() : loop_thread.join();
             }
@@ -352,8 +1274,69 @@ namespace un::event {
         }
 
       private:
+        void push_intrusive(detail::intrusive_job* j, const std::source_location& loc) {
+            j->next = nullptr;
+
+            {
+                std::lock_guard lock{job_queue_mutex};
+                *intrusive_tail = j;
+                intrusive_tail = &j->next;
+                jobs_pending.store(true);
+            }
+
+            wake_for_job(loc);
+        }
+
+        blocking_pool& blocking_executor() { return opts.blocking ? *opts.blocking : blocking_pool::shared(); }
+
+        // Runs on a helper thread; the lock keeps the owner from being destroyed under it
+        static void complete_blocking(
+                blocking_handoff& h, std::move_only_function<void()> f, const std::source_location& loc) {
+            std::lock_guard lock{h.mutex};
+            // the loop is gone, and `f` (with the `done` it carries) along with it
+            if (not h.owner) {
+                return;
+            }
+
+            auto first = h.done.empty();
+            h.done.push_back(std::move(f));
+            if (first) {
+                h.owner->enqueue([self = h.owner] { self->run_blocking_completions(); }, loc, true);
+            }
+            h.owner->blocking_inflight.fetch_sub(1, std::memory_order_release);
+        }
+
+        void run_blocking_completions() {
+            decltype(handoff->done) batch;
+            {
+                std::lock_guard lock{handoff->mutex};
+                batch.swap(handoff->done);
+            }
+
+            for (auto& f : batch) {
+                try {
+                    f();
+                } catch (const std::exception& e) {
+                    unlog::critical(log, "Blocking completion threw exception: {}", e.what());
+                } catch (...) {
+                    unlog::critical(log, "Blocking completion threw non-std exception");
+                }
+            }
+        }
+
+        void wake_for_job(const std::source_location& loc) {
+            // a spinning loop thread will find the job on its next poll; pairs with the seq_cst
+            // store/load of `spinning` and `jobs_pending` in run_spinning()
+            if (not spinning.load()) {
+                if (auto* t = active_trace.load(std::memory_order_acquire)) {
+                    t->emit(trace_kind::wakeup, trace_buffer::now_ns(), 0, 0, loc.file_name(), loc.line());
+                }
+                event_active(job_waker.get(), 0, 0);
+            }
+        }
+
         template <std::invocable Callable>
-        void add_oneshot_event(std::chrono::microseconds delay, Callable hook) {
+        void add_oneshot_event(std::chrono::microseconds delay, Callable hook, std::source_location loc) {
             auto handler = make_handler(unevent_loop::loop_id);
             auto& h = *handler;
 
@@ -365,22 +1348,204 @@ namespace un::event {
                         func();
                         h.reset();
                     },
-                    true);
+                    true,
+                    true,
+                    loc);
         }
 
-        void shutdown() {
-            unlog::trace(log, "{} called", __PRETTY_FUNCTION__);
+        template <std::invocable Callable>
+        bool enqueue(Callable f, const std::source_location& loc, bool force) {
+            if (not accepting(force)) {
+                return false;
+            }
 
+            // the parent site is only meaningful (and only safe to read) from the loop thread
+            auto parent = (slow_threshold.count() and in_event_loop()) ? running_site : std::source_location{};
+
+            {
+                std::lock_guard lock{job_queue_mutex};
+                job_queue.emplace_back(std::move(f), loc, parent);
+                jobs_pending.store(true);
+            }
+
+#if UNEVENT_METRICS
+            metrics_state.jobs_posted.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+            wake_for_job(loc);
+            return true;
+        }
+
+        // While draining, only the loop thread itself may add work; once closed, nobody may
+        bool accepting(bool force) {
+            auto p = phase.load(std::memory_order_acquire);
+            if (force or p == loop_phase::open or (p == loop_phase::draining and in_event_loop())) {
+                return true;
+            }
+            rejected_posts.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        static bool is_oneshot(const ev_watcher& w) noexcept { return not w.persistent and not w.fixed_rate; }
+
+        // (Re)arms `w` on the manual clock, like event_add on a pending event; from any thread, as
+        // watchers are started and stopped wherever their owners are
+        void schedule_virtual(ev_watcher& w, std::chrono::steady_clock::time_point due) {
+            call_get([&] {
+                if (w.slot) {
+                    virtual_timers.erase(*w.slot);
+                }
+                w.slot = virtual_timers.emplace(due, &w);
+            });
+        }
+
+        void cancel_virtual(ev_watcher& w) {
+            call_get([&] {
+                if (w.slot) {
+                    virtual_timers.erase(*w.slot);
+                    w.slot.reset();
+                }
+            });
+        }
+
+        // Fires, in deadline order, every timer due by `t`, with the clock set to each deadline in turn
+        void run_timers_until(std::chrono::steady_clock::time_point t) {
+            auto clock = opts.clock;
+            clock->firing.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+            while (not virtual_timers.empty() and virtual_timers.begin()->first <= t) {
+                auto it = virtual_timers.begin();
+                auto* w = it->second;
+                auto due = std::max(it->first, now());
+                virtual_timers.erase(it);
+                w->slot.reset();
+
+                clock->set(due);
+                // EV_PERSIST re-arms before the callback too; fixed-rate tickers re-arm themselves
+                if (w->persistent) {
+                    schedule_virtual(*w, due + std::max(w->period, std::chrono::microseconds{1}));
+                }
+                ev_watcher::on_timer(-1, EV_TIMEOUT, w);
+                if (orphaned_base) {
+                    break;
+                }
+            }
+
+            clock->firing.store({}, std::memory_order_relaxed);
+        }
+
+        template <typename Fn>
+        void for_each_watcher(Fn&& fn) {
             for (auto& [id, list] : tickers) {
-                std::ranges::for_each(list, [](auto&& t) {
-                    if (auto tick = t.lock()) {
-                        tick->f = nullptr;
-                        tick->stop();
+                for (auto& t : list) {
+                    if (auto tick = t.lock(); tick and tick->f) {
+                        fn(tick);
                     }
-                });
+                }
             }
+        }
+
+        static void retire(const std::shared_ptr<ev_watcher>& tick) {
+            // clearing `f` also releases a one-shot watcher's reference to itself
+            tick->stop();
+            tick->f = nullptr;
+        }
+
+        // Stops repeating tickers and one-shots due after `deadline`; returns the number of one-shots
+        size_t begin_drain(std::chrono::steady_clock::time_point deadline) {
+            size_t dropped{0};
+            for_each_watcher([&](const std::shared_ptr<ev_watcher>& tick) {
+                if (not is_oneshot(*tick)) {
+                    retire(tick);
+                }
+                // nothing advances a manual clock during the drain, so its timers would only wait out the deadline
+                else if (opts.clock or tick->deadline.load(std::memory_order_relaxed) > deadline) {
+                    ++dropped;
+                    retire(tick);
+                }
+            });
+            return dropped;
+        }
+
+        bool drained() {
+            if (blocking_inflight.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (batch_remaining and not batch_remaining->empty()) {
+                return false;
+            }
+            if (posted_batch) {
+                return false;
+            }
+
+            {
+                std::lock_guard lock{job_queue_mutex};
+                if (not job_queue.empty() or intrusive_head) {
+                    return false;
+                }
+            }
+
+            bool timers{false};
+            for_each_watcher([&](const std::shared_ptr<ev_watcher>& tick) {
+                timers = timers or (is_oneshot(*tick) and tick->pending());
+            });
+            return not timers;
+        }
 
+        void close(shutdown_report& report) {
+            unlog::trace(log, "{} called", __PRETTY_FUNCTION__);
+
+            phase.store(loop_phase::closed, std::memory_order_release);
             running.store(false, std::memory_order_release);
+
+            for_each_watcher([&](const std::shared_ptr<ev_watcher>& tick) {
+                if (is_oneshot(*tick) and tick->pending()) {
+                    ++report.timers_dropped;
+                }
+                retire(tick);
+            });
+
+            decltype(job_queue) dropped;
+            detail::intrusive_job* cancelled;
+            {
+                std::lock_guard lock{job_queue_mutex};
+                dropped.swap(job_queue);
+                cancelled = std::exchange(intrusive_head, nullptr);
+                intrusive_tail = &intrusive_head;
+            }
+
+            report.jobs_dropped += dropped.size() + std::exchange(abandoned_jobs, 0);
+
+            // called from a job: the rest of its batch is dropped here rather than by process_job_queue
+            if (batch_remaining) {
+                report.jobs_dropped += batch_remaining->size();
+                batch_remaining->clear();
+            }
+            while (posted_batch) {
+                auto* j = std::exchange(posted_batch, posted_batch->next);
+                j->run(j, true);
+                ++report.jobs_dropped;
+            }
+
+#if UNEVENT_METRICS
+            loop_metrics::bump(metrics_state.jobs_dropped, dropped.size());
+#endif
+
+            while (cancelled) {
+                auto* j = std::exchange(cancelled, cancelled->next);
+                j->run(j, true);
+                ++report.jobs_dropped;
+            }
+
+            stop_tracked();
+        }
+
+        void stop_tracked() {
+            while (tracked_head) {
+                auto* op = tracked_head;
+                untrack(op);
+                op->stop(op);
+            }
         }
 
         void clear_old_tickers() {
@@ -397,8 +1562,19 @@ namespace un::event {
         }
 
         std::shared_ptr<ev_watcher> make_handler(caller_id_t _id) {
-            clear_old_tickers();
+            // sweeping expired entries is O(n); only do it once the tracked count has doubled so that
+            // inserting n timers stays O(n) overall
+            if (++tracked_tickers >= sweep_threshold) {
+                clear_old_tickers();
+                tracked_tickers = 0;
+                for (auto& [id, list] : tickers) {
+                    tracked_tickers += list.size();
+                }
+                sweep_threshold = std::max<size_t>(64, 2 * tracked_tickers);
+            }
+
             auto t = make_shared<unevent_loop::ev_watcher>();
+            t->owner = this;
             tickers[_id].push_back(t);
             return t;
         }
@@ -407,10 +1583,14 @@ namespace un::event {
 
         template <typename Callable>
         [[nodiscard]] std::shared_ptr<ev_watcher> _call_every(
-                std::chrono::microseconds interval, Callable&& f, caller_id_t _id, bool start_immediately) {
+                std::chrono::microseconds interval,
+                Callable&& f,
+                caller_id_t _id,
+                bool start_immediately,
+                std::source_location loc) {
             auto h = make_handler(_id);
 
-            h->init_event(loop(), interval, std::forward<Callable>(f), false, start_immediately);
+            h->init_event(loop(), interval, std::forward<Callable>(f), false, start_immediately, loc);
 
             return h;
         }
@@ -421,15 +1601,132 @@ namespace un::event {
                     -1,
                     0,
                     [](evutil_socket_t, short, void* self) {
-                        unlog::trace(log, "processing job queue");
+                        if constexpr (detail::hot_trace_enabled) {
+                            unlog::trace(log, "processing job queue");
+                        }
                         static_cast<unevent_loop*>(self)->process_job_queue();
                     },
                     this));
             assert(job_waker);
         }
 
-        void process_job_queue() {
-            unlog::trace(log, "Event loop processing job queue");
+        void run_spinning() {
+            auto* base = ev_loop.get();
+            auto idle_since = detail::get_time();
+
+            spinning.store(true);
+
+            while (not stopping.load(std::memory_order_acquire)) {
+                event_base_loop(base, EVLOOP_NONBLOCK);
+                if (orphaned_base) {
+                    return;
+                }
+
+                if (jobs_pending.load(std::memory_order_acquire) and process_job_queue() > 0) {
+                    if (orphaned_base) {
+                        return;
+                    }
+                    idle_since = detail::get_time();
+                    continue;
+                }
+
+                if (detail::get_time() - idle_since < opts.spin_budget) {
+                    detail::cpu_relax();
+                    continue;
+                }
+
+                // idle budget exhausted: advertise that producers must wake us, then re-check the queue
+                // so that a post racing with the store above is not stranded
+                spinning.store(false);
+                if (not jobs_pending.load() and not stopping.load()) {
+                    if constexpr (detail::hot_trace_enabled) {
+                        unlog::trace(log, "Spinning loop parking after {}us idle", opts.spin_budget.count());
+                    }
+                    event_base_loop(base, EVLOOP_ONCE | EVLOOP_NO_EXIT_ON_EMPTY);
+                    if (orphaned_base) {
+                        return;
+                    }
+                }
+                spinning.store(true);
+                idle_since = detail::get_time();
+            }
+
+            spinning.store(false);
+        }
+
+        // Returns the callback start time when metrics or the watchdog need it, else a zero time_point
+        std::chrono::steady_clock::time_point begin_callback(const std::source_location& site) {
+            running_site = site;
+            bool timed = metrics_enabled or slow_threshold.count() or active_trace.load(std::memory_order_relaxed);
+            return timed ? detail::get_time() : std::chrono::steady_clock::time_point{};
+        }
+
+        void end_callback(
+                callback_kind kind,
+                std::chrono::steady_clock::time_point started,
+                const std::source_location& site,
+                const std::source_location& parent) {
+            running_site = {};
+
+            if (started == std::chrono::steady_clock::time_point{}) {
+                return;
+            }
+
+            auto elapsed = detail::get_time() - started;
+
+            if (auto* t = active_trace.load(std::memory_order_acquire)) {
+                t->emit(kind == callback_kind::job ? trace_kind::job : trace_kind::timer,
+                        loop_metrics::to_ns(started.time_since_epoch()),
+                        loop_metrics::to_ns(elapsed),
+                        0,
+                        site.file_name(),
+                        site.line());
+            }
+
+#if UNEVENT_METRICS
+            if (kind == callback_kind::job) {
+                metrics_state.job_duration_ns.record(loop_metrics::to_ns(elapsed));
+                loop_metrics::bump(metrics_state.jobs_run);
+            }
+#endif
+
+            if (slow_threshold.count() and elapsed > slow_threshold) {
+                report_slow_callback(slow_callback_report{
+                        .kind = kind,
+                        .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed),
+                        .site = site,
+                        .parent = parent});
+            }
+        }
+
+        void report_slow_callback(const slow_callback_report& r) {
+            if (opts.on_slow_callback) {
+                try {
+                    opts.on_slow_callback(r);
+                } catch (const std::exception& e) {
+                    unlog::critical(log, "Slow callback hook threw exception: {}", e.what());
+                }
+                return;
+            }
+
+            unlog::critical(
+                    log,
+                    "Slow {} callback took {}us (threshold {}us); scheduled at {}:{} ({}){}{}:{}",
+                    r.kind == callback_kind::job ? "job" : "timer",
+                    std::chrono::duration_cast<std::chrono::microseconds>(r.duration).count(),
+                    opts.slow_callback_threshold.count(),
+                    r.site.file_name(),
+                    r.site.line(),
+                    r.site.function_name(),
+                    r.parent.line() ? " from job at " : "",
+                    r.parent.file_name(),
+                    r.parent.line());
+        }
+
+        size_t process_job_queue() {
+            if constexpr (detail::hot_trace_enabled) {
+                unlog::trace(log, "Event loop processing job queue");
+            }
             assert(in_event_loop());
 
             decltype(job_queue) swapped_queue;
@@ -437,20 +1734,78 @@ namespace un::event {
             {
                 std::lock_guard<std::mutex> lock{job_queue_mutex};
                 job_queue.swap(swapped_queue);
+                posted_batch = std::exchange(intrusive_head, nullptr);
+                intrusive_tail = &intrusive_head;
+                jobs_pending.store(false, std::memory_order_relaxed);
             }
 
+            auto n = swapped_queue.size();
+            batch_remaining = &swapped_queue;
+            auto* tracer = active_trace.load(std::memory_order_acquire);
+            auto drain_start = tracer ? trace_buffer::now_ns() : 0;
+
+#if UNEVENT_METRICS
+            auto& m = metrics_state;
+            loop_metrics::bump(m.drains);
+            m.drain_size.record(n);
+#endif
+
             while (not swapped_queue.empty() && running.load(std::memory_order_acquire)) {
+                auto front = std::move(swapped_queue.front());
+                static_assert(std::same_as<std::decay_t<decltype(front)>, queued_job>);
+                swapped_queue.pop_front();
+
+                auto started = begin_callback(front.site);
+#if UNEVENT_METRICS
+                m.queue_delay_ns.record(loop_metrics::to_ns(started - front.posted));
+#endif
+
                 try {
-                    auto front = std::move(swapped_queue.front());
-                    static_assert(std::same_as<std::decay_t<decltype(front)>, job_hook>);
-                    swapped_queue.pop_front();
-                    front();
+                    front.f();
                 } catch (const std::exception& e) {
                     unlog::critical(log, "Queued job threw exception: {}", e.what());
+#if UNEVENT_METRICS
+                    loop_metrics::bump(m.job_exceptions);
+#endif
                 } catch (...) {
                     unlog::critical(log, "Queued job threw non-std exception");
+#if UNEVENT_METRICS
+                    loop_metrics::bump(m.job_exceptions);
+#endif
                 }
+
+                if (orphaned_base) {
+                    return n;
+                }
+                end_callback(callback_kind::job, started, front.site, front.parent);
             }
+
+#if UNEVENT_METRICS
+            loop_metrics::bump(m.jobs_dropped, swapped_queue.size());
+#endif
+
+            batch_remaining = nullptr;
+            // released before any posted job runs, since one of them may be shutdown's close step
+            abandoned_jobs += swapped_queue.size();
+            swapped_queue.clear();
+
+            while (posted_batch) {
+                auto* j = std::exchange(posted_batch, posted_batch->next);
+                auto cancelled = not running.load(std::memory_order_acquire);
+                j->run(j, cancelled);
+                if (orphaned_base) {
+                    return n + 1;
+                }
+                abandoned_jobs += cancelled;
+                ++n;
+            }
+
+            // `tracer` outlives the loop's use of it; it is only freed with the loop itself
+            if (tracer) {
+                tracer->emit(trace_kind::drain, drain_start, trace_buffer::now_ns() - drain_start, n);
+            }
+
+            return n;
         }
         friend struct test::test_helper;
     };
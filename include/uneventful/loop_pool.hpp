@@ -0,0 +1,96 @@
+#pragma once
+
+#include "dns.hpp"
+#include "http.hpp"
+#include "loop.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace un::event {
+    /** A fixed set of loops sharing one set of options, each on its own thread. `next()` hands out
+        loops round-robin (one relaxed fetch_add), which is how the pool spreads work: posting to
+        `pool.next()` or scheduling through `exec::get_scheduler(pool)`.
+
+        When `options.thread.cpu_affinity` is non-empty, loop `i` is pinned to the single cpu
+        `cpu_affinity[i % size]` instead of the whole set, and `options.thread.name` gets `-i`
+        appended so the loops are distinguishable in `top -H`.
+     */
+    template <auto& C>
+    class loop_pool {
+        using loop_type = unevent_loop<C>;
+
+        std::vector<std::shared_ptr<loop_type>> loops;
+        std::atomic<size_t> cursor{0};
+
+      public:
+        explicit loop_pool(size_t n, const loop_options& options = {}) {
+            if (n == 0) {
+                throw std::invalid_argument{"loop_pool needs at least one loop"};
+            }
+
+            loops.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                auto opts = options;
+                if (not opts.thread.cpu_affinity.empty()) {
+                    opts.thread.cpu_affinity = {options.thread.cpu_affinity[i % options.thread.cpu_affinity.size()]};
+                }
+                if (not opts.thread.name.empty()) {
+                    opts.thread.name += "-" + std::to_string(i);
+                }
+                loops.push_back(loop_type::make(std::move(opts)));
+            }
+        }
+
+        loop_pool(const loop_pool&) = delete;
+        loop_pool& operator=(const loop_pool&) = delete;
+
+        size_t size() const noexcept { return loops.size(); }
+
+        const std::shared_ptr<loop_type>& operator[](size_t i) const noexcept { return loops[i]; }
+
+        const std::shared_ptr<loop_type>& next() noexcept {
+            return loops[cursor.fetch_add(1, std::memory_order_relaxed) % loops.size()];
+        }
+
+        /** Creates a resolver on every loop, all sharing `opts.cache` (made here if null), so that a
+            name resolved on any loop is then answered from memory on all of them.
+         */
+        std::vector<std::shared_ptr<typename loop_type::dns_resolver>> make_resolvers(dns_options opts = {}) {
+            if (not opts.cache) {
+                opts.cache = std::make_shared<dns_cache>();
+            }
+
+            std::vector<std::shared_ptr<typename loop_type::dns_resolver>> resolvers;
+            resolvers.reserve(loops.size());
+            for (auto& l : loops) {
+                resolvers.push_back(l->make_resolver(opts));
+            }
+            return resolvers;
+        }
+
+        /** Starts an HTTP server on every loop, all listening on `opts.port` with SO_REUSEPORT so that
+            the kernel spreads incoming connections across the loops; with port 0 the first server
+            picks a free port and the rest join it. `setup` runs once per server, on its loop thread,
+            before that server starts listening.
+         */
+        std::vector<std::shared_ptr<typename loop_type::http_server>> serve_http(
+                http_options opts, const std::function<void(typename loop_type::http_server&)>& setup) {
+            opts.reuse_port = true;
+
+            std::vector<std::shared_ptr<typename loop_type::http_server>> servers;
+            servers.reserve(loops.size());
+            for (auto& l : loops) {
+                servers.push_back(l->make_http_server(opts, setup));
+                opts.port = servers.front()->port();
+            }
+            return servers;
+        }
+
+        auto begin() const noexcept { return loops.begin(); }
+        auto end() const noexcept { return loops.end(); }
+    };
+}  // namespace un::event
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <vector>
+
+namespace un::event {
+#if UNEVENT_METRICS
+    inline constexpr bool metrics_enabled{true};
+#else
+    inline constexpr bool metrics_enabled{false};
+#endif
+
+    struct histogram_snapshot {
+        uint64_t count{0};
+        uint64_t sum{0};
+        uint64_t max{0};
+        // (inclusive upper bound, count) for every non-empty bucket, in ascending order
+        std::vector<std::pair<uint64_t, uint64_t>> buckets{};
+
+        double mean() const noexcept { return count ? static_cast<double>(sum) / count : 0.0; }
+
+        // Returns the upper bound of the bucket holding the `p`th percentile, p in [0, 1]
+        uint64_t percentile(double p) const noexcept {
+            if (count == 0) {
+                return 0;
+            }
+
+            auto target = static_cast<uint64_t>(p * count);
+            uint64_t seen{0};
+            for (const auto& [upper, n] : buckets) {
+                seen += n;
+                if (seen > target) {
+                    return std::min(upper, max);
+                }
+            }
+            return max;
+        }
+    };
+
+    /** HDR-style log-linear histogram: each power-of-two range is split into 2^SubBits linear
+        sub-buckets, giving a constant relative error of 2^-SubBits over the full uint64_t range
+        with a fixed, allocation-free footprint.
+
+        Recording is single-writer (the loop thread) and uses plain relaxed load/store pairs
+        rather than locked read-modify-writes; snapshots may be taken from any thread.
+     */
+    template <size_t SubBits = 3>
+    class log_histogram {
+        static constexpr size_t sub_buckets{1U << SubBits};
+        static constexpr size_t num_buckets{(64 - SubBits + 1) * sub_buckets};
+
+        std::array<std::atomic<uint64_t>, num_buckets> counts{};
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+
+        static void bump(std::atomic<uint64_t>& a, uint64_t n = 1) noexcept {
+            a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+      public:
+        static constexpr size_t index_of(uint64_t v) noexcept {
+            if (v < sub_buckets) {
+                return static_cast<size_t>(v);
+            }
+            auto shift = static_cast<size_t>(std::bit_width(v)) - 1 - SubBits;
+            return (shift + 1) * sub_buckets + static_cast<size_t>((v >> shift) & (sub_buckets - 1));
+        }
+
+        static constexpr uint64_t upper_bound_of(size_t idx) noexcept {
+            if (idx < sub_buckets) {
+                return idx;
+            }
+            auto shift = idx / sub_buckets - 1;
+            auto base = (sub_buckets | (idx % sub_buckets)) << shift;
+            return base + ((uint64_t{1} << shift) - 1);
+        }
+
+        void record(uint64_t v) noexcept {
+            bump(counts[index_of(v)]);
+            bump(total);
+            bump(sum, v);
+            if (v > max.load(std::memory_order_relaxed)) {
+                max.store(v, std::memory_order_relaxed);
+            }
+        }
+
+        histogram_snapshot snapshot() const {
+            histogram_snapshot s{
+                    .count = total.load(std::memory_order_relaxed),
+                    .sum = sum.load(std::memory_order_relaxed),
+                    .max = max.load(std::memory_order_relaxed)};
+
+            for (size_t i = 0; i < num_buckets; ++i) {
+                if (auto n = counts[i].load(std::memory_order_relaxed)) {
+                    s.buckets.emplace_back(upper_bound_of(i), n);
+                }
+            }
+
+            return s;
+        }
+    };
+
+    struct metrics_snapshot {
+        uint64_t jobs_posted{0};
+        uint64_t jobs_run{0};
+        uint64_t jobs_dropped{0};
+        uint64_t job_exceptions{0};
+        uint64_t drains{0};
+        uint64_t timer_fires{0};
+
+        // jobs posted but not yet run or dropped at the time of the snapshot
+        uint64_t queue_depth{0};
+
+        histogram_snapshot queue_delay_ns{};   // call_soon to start of execution
+        histogram_snapshot job_duration_ns{};  // execution time of each queued job
+        histogram_snapshot drain_size{};       // jobs handled per process_job_queue pass
+        histogram_snapshot timer_lag_ns{};     // actual minus scheduled fire time for timers
+    };
+
+    /** Per-loop counters and histograms. Everything but `jobs_posted` is written only by the loop
+        thread; the whole structure is compiled out unless UNEVENT_METRICS is set.
+     */
+    struct loop_metrics {
+        std::atomic<uint64_t> jobs_posted{0};
+        std::atomic<uint64_t> jobs_run{0};
+        std::atomic<uint64_t> jobs_dropped{0};
+        std::atomic<uint64_t> job_exceptions{0};
+        std::atomic<uint64_t> drains{0};
+        std::atomic<uint64_t> timer_fires{0};
+
+        log_histogram<> queue_delay_ns;
+        log_histogram<> job_duration_ns;
+        log_histogram<> drain_size;
+        log_histogram<> timer_lag_ns;
+
+        static uint64_t to_ns(std::chrono::steady_clock::duration d) noexcept {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+            return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        }
+
+        static void bump(std::atomic<uint64_t>& a, uint64_t n = 1) noexcept {
+            a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        metrics_snapshot snapshot() const {
+            metrics_snapshot s{
+                    .jobs_posted = jobs_posted.load(std::memory_order_relaxed),
+                    .jobs_run = jobs_run.load(std::memory_order_relaxed),
+                    .jobs_dropped = jobs_dropped.load(std::memory_order_relaxed),
+                    .job_exceptions = job_exceptions.load(std::memory_order_relaxed),
+                    .drains = drains.load(std::memory_order_relaxed),
+                    .timer_fires = timer_fires.load(std::memory_order_relaxed),
+                    .queue_delay_ns = queue_delay_ns.snapshot(),
+                    .job_duration_ns = job_duration_ns.snapshot(),
+                    .drain_size = drain_size.snapshot(),
+                    .timer_lag_ns = timer_lag_ns.snapshot()};
+
+            auto done = s.jobs_run + s.jobs_dropped;
+            s.queue_depth = s.jobs_posted > done ? s.jobs_posted - done : 0;
+
+            return s;
+        }
+    };
+}  // namespace un::event
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <vector>
+
+namespace un::event {
+    class blocking_pool;
+    class manual_clock;
+
+    enum class sched_policy : uint8_t {
+        inherit,  // leave the policy of the constructing thread untouched
+        other,    // SCHED_OTHER
+        batch,    // SCHED_BATCH
+        idle,     // SCHED_IDLE
+        fifo,     // SCHED_FIFO; requires CAP_SYS_NICE or a suitable RLIMIT_RTPRIO
+        rr,       // SCHED_RR; same privilege requirements as fifo
+    };
+
+    /** Attributes applied to the loop thread before it enters `event_base_loop`. Any failure to apply a
+        requested attribute is treated as fatal and rethrown from `unevent_loop::make()`.
+
+            - name : thread name as seen by `top -H`, `perf` and debuggers (truncated to 15 characters)
+            - cpu_affinity : set of cpus the loop thread may run on; empty inherits the creator's mask
+            - policy/priority : scheduling class; priority is only meaningful for fifo/rr
+            - nice : per-thread niceness, applied for the non-realtime policies
+            - numa_node : preferred memory node for every allocation made from the loop thread (job
+                queues, allocazam pools, watchers), set before the loop allocates anything
+     */
+    struct thread_options {
+        std::string name{};
+        std::vector<int> cpu_affinity{};
+        sched_policy policy{sched_policy::inherit};
+        int priority{0};
+        std::optional<int> nice{};
+        std::optional<int> numa_node{};
+    };
+
+    enum class callback_kind : uint8_t { job, timer };
+
+    struct slow_callback_report {
+        callback_kind kind;
+        std::chrono::nanoseconds duration;
+        // call site of the call_soon/call_later/call_every that scheduled the callback
+        std::source_location site;
+        // site of the job that was running on the same loop when `site` was invoked; empty (line 0)
+        // when it was scheduled from another thread
+        std::source_location parent;
+    };
+
+    using slow_callback_hook = std::function<void(const slow_callback_report&)>;
+
+    struct loop_options {
+        thread_options thread{};
+
+        /** Busy-poll mode: when non-zero, the loop thread spins on the job queue and non-blocking
+            `event_base_loop` passes for up to `spin_budget` of idle time before falling back to
+            blocking. While spinning, cross-thread posts skip the wakeup entirely. This trades a
+            fully busy core for sub-microsecond `call_soon` latency; leave at zero unless the loop
+            owns a dedicated (ideally isolated) cpu.
+         */
+        std::chrono::microseconds spin_budget{0};
+
+        /** Slow-callback watchdog: when non-zero, every queued job and timer callback is timed and
+            any taking longer than the threshold is reported with the source location it was
+            scheduled from. Reports are delivered synchronously on the loop thread to
+            `on_slow_callback`, or logged at critical level when no hook is set. When zero the only
+            cost is carrying the captured source location alongside each job.
+         */
+        std::chrono::microseconds slow_callback_threshold{0};
+        slow_callback_hook on_slow_callback{};
+
+        // Number of records in the trace ring allocated by the first `start_tracing()` call
+        size_t trace_capacity{1U << 16};
+
+        // Helper threads for `call_blocking`; when null the process-wide `blocking_pool::shared()`
+        std::shared_ptr<blocking_pool> blocking{};
+
+        // Virtual time for the loop's timers, which then only fire when it is advanced (see `manual_clock`)
+        std::shared_ptr<manual_clock> clock{};
+    };
+
+    namespace detail {
+        // Applies `opts` to the calling thread; throws std::system_error on failure
+        void apply_thread_options(const thread_options& opts);
+    }  // namespace detail
+}  // namespace un::event
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <utility>
+
+namespace un::event {
+    struct parallel_options {
+        // smallest number of indices handed out as one chunk
+        size_t min_grain{1};
+        // longest a loop keeps running chunks before yielding back to its own I/O and jobs
+        std::chrono::microseconds slice{500};
+    };
+
+    namespace detail {
+        /** Shared by the caller and one worker job per loop. Chunks are claimed from a single cursor
+            with guided sizing (a fraction of what is left, never below `min_grain`), so early chunks
+            are large and the tail is split finely enough to even out across loops. `done` counts
+            finished indices and is the only thing the caller waits on.
+         */
+        template <typename Body>
+        class parallel_state {
+            Body* body;
+            const size_t count;
+            const size_t workers;
+            const size_t min_grain;
+
+            std::atomic<size_t> cursor{0};
+            std::atomic<size_t> done{0};
+            std::atomic<bool> failed{false};
+            std::exception_ptr error{};
+
+            bool grab(size_t& b, size_t& e) noexcept {
+                b = cursor.load(std::memory_order_relaxed);
+                do {
+                    if (b >= count) {
+                        return false;
+                    }
+                    e = std::min(count, b + std::max(min_grain, (count - b) / (2 * workers)));
+                } while (not cursor.compare_exchange_weak(b, e, std::memory_order_relaxed));
+                return true;
+            }
+
+            void complete(size_t n) noexcept {
+                if (done.fetch_add(n, std::memory_order_acq_rel) + n == count) {
+                    done.notify_all();
+                }
+            }
+
+            void fail(std::exception_ptr e) noexcept {
+                if (not failed.exchange(true, std::memory_order_acq_rel)) {
+                    error = std::move(e);
+                }
+                // nobody claims the rest; count it as finished so the caller is released
+                if (auto b = cursor.exchange(count, std::memory_order_relaxed); b < count) {
+                    complete(count - b);
+                }
+            }
+
+          public:
+            const std::chrono::microseconds slice;
+
+            parallel_state(Body& b, size_t n, size_t w, const parallel_options& opts) :
+                    body{&b},
+                    count{n},
+                    workers{w},
+                    min_grain{std::max<size_t>(opts.min_grain, 1)},
+                    slice{opts.slice} {}
+
+            // Runs chunks until none are left (false) or `until` has passed (true)
+            bool work(std::chrono::steady_clock::time_point until) {
+                size_t b, e;
+                while (grab(b, e)) {
+                    try {
+                        (*body)(b, e);
+                    } catch (...) {
+                        fail(std::current_exception());
+                    }
+                    complete(e - b);
+
+                    if (detail::get_time() >= until) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void join() {
+                for (auto d = done.load(std::memory_order_acquire); d != count; d = done.load(std::memory_order_acquire)) {
+                    done.wait(d, std::memory_order_acquire);
+                }
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+        template <typename Loop, typename Body>
+        void parallel_worker(std::shared_ptr<parallel_state<Body>> st, Loop* loop) {
+            if (st->work(detail::get_time() + st->slice)) {
+                // requeue behind whatever else the loop has to do; a refused post (loop shutting
+                // down) just leaves the remaining chunks to the other workers and the caller
+                loop->call_soon([st = std::move(st), loop]() mutable { parallel_worker(std::move(st), loop); });
+            }
+        }
+
+        // Runs `body(b, e)` over [0, count) on `loops` and the calling thread, returning once all
+        // of it has run
+        template <typename Loops, typename Body>
+        void parallel_run(Loops& loops, size_t count, Body& body, const parallel_options& opts) {
+            if (count == 0) {
+                return;
+            }
+
+            auto workers = static_cast<size_t>(std::ranges::distance(loops)) + 1;
+            auto st = std::make_shared<parallel_state<Body>>(body, count, workers, opts);
+
+            for (auto& l : loops) {
+                // a loop calling in takes part directly; its own queue is blocked until we return
+                if (not l->in_event_loop()) {
+                    l->call_soon([st, loop = std::to_address(l)] { parallel_worker(st, loop); });
+                }
+            }
+
+            st->work(std::chrono::steady_clock::time_point::max());
+            st->join();
+        }
+    }  // namespace detail
+
+    /** Calls `f(i)` for every i in [first, last), or `f(b, e)` for consecutive sub-ranges covering
+        it, spread over `loops` (a `loop_pool` or any range of loop pointers) and the calling
+        thread, and returns once every call has finished. Each loop runs chunks for at most
+        `opts.slice` per job before requeueing itself, so its I/O and other jobs keep being served.
+
+        The first exception thrown by `f` stops further chunks from being handed out and is
+        rethrown here once the chunks already running have finished. May be called from one of the
+        loops' own threads, which then does its share inline.
+     */
+    template <std::ranges::range Loops, std::integral I, typename F>
+    void parallel_for(Loops&& loops, I first, I last, F&& f, const parallel_options& opts = {}) {
+        auto body = [&](size_t b, size_t e) {
+            if constexpr (std::invocable<F&, I, I>) {
+                f(static_cast<I>(first + b), static_cast<I>(first + e));
+            }
+            else {
+                for (auto i = b; i < e; ++i) {
+                    f(static_cast<I>(first + i));
+                }
+            }
+        };
+
+        detail::parallel_run(loops, last > first ? static_cast<size_t>(last - first) : 0, body, opts);
+    }
+
+    /** Folds `map(i)` over [first, last) with `reduce`, starting every chunk from `identity`, as
+        `parallel_for` does. Chunk results are combined in index order, so `reduce` needs to be
+        associative but not commutative.
+     */
+    template <std::ranges::range Loops, std::integral I, typename T, typename Map, typename Reduce>
+    T parallel_reduce(
+            Loops&& loops, I first, I last, T identity, Map&& map, Reduce&& reduce, const parallel_options& opts = {}) {
+        std::mutex partials_mutex;
+        std::map<size_t, T> partials;
+
+        auto body = [&](size_t b, size_t e) {
+            T acc = identity;
+            for (auto i = b; i < e; ++i) {
+                acc = reduce(std::move(acc), map(static_cast<I>(first + i)));
+            }
+
+            std::lock_guard lock{partials_mutex};
+            partials.emplace(b, std::move(acc));
+        };
+
+        detail::parallel_run(loops, last > first ? static_cast<size_t>(last - first) : 0, body, opts);
+
+        for (auto& [_, p] : partials) {
+            identity = reduce(std::move(identity), std::move(p));
+        }
+        return identity;
+    }
+}  // namespace un::event
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace un::event {
+#if UNEVENT_EMBEDDED
+    using pool_chunk_allocator = allocazam::allocazam_std_allocator<
+            std::byte,
+            allocazam::memory_mode::dynamic,
+            allocazam::allocation_model::suballocated,
+            allocazam::huge_pages::disabled>;
+#else
+    using pool_chunk_allocator = allocazam::allocazam_std_allocator<
+            std::byte,
+            allocazam::memory_mode::dynamic,
+            allocazam::allocation_model::suballocated,
+            allocazam::huge_pages::enabled>;
+#endif
+
+    /** Size-classed free lists backing a loop's `make_shared`. Memory is carved from large chunks
+        obtained through allocazam and recycled per size class; nothing is returned to the system
+        until the pool itself is destroyed.
+
+        The owning loop thread allocates and frees through a plain singly-linked list with no
+        synchronization. Frees from any other thread are pushed onto a lock-free stack that the loop
+        thread adopts wholesale the next time its own list runs dry; allocations from other threads
+        take a mutex. Requests larger than `max_size` (or over-aligned) go straight to operator new.
+     */
+    class object_pool {
+        struct node {
+            node* next;
+        };
+
+        struct size_class {
+            node* local{nullptr};                // owner thread only
+            std::atomic<node*> remote{nullptr};  // pushed by non-owner frees
+            node* shared{nullptr};               // non-owner allocations, under `mutex`
+        };
+
+      public:
+        static constexpr size_t granularity{16};
+        static constexpr size_t max_size{512};
+        static constexpr size_t chunk_size{1U << 20};
+        // bytes carved from the current chunk per refill of a single size class
+        static constexpr size_t run_size{4096};
+
+        object_pool() = default;
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+        ~object_pool();
+
+        static constexpr bool pooled(size_t size, size_t align) noexcept {
+            return size <= max_size and align <= granularity;
+        }
+
+        void* allocate(size_t size, size_t align, bool on_owner);
+        void deallocate(void* p, size_t size, size_t align, bool on_owner) noexcept;
+
+        // Total bytes obtained from the chunk allocator so far
+        size_t reserved() const;
+
+      private:
+        std::array<size_class, max_size / granularity> classes{};
+
+        mutable std::mutex mutex;
+        std::vector<std::byte*> chunks;
+        std::byte* bump{nullptr};
+        std::byte* bump_end{nullptr};
+
+        static constexpr size_t class_of(size_t size) noexcept {
+            return (std::max<size_t>(size, 1) + granularity - 1) / granularity - 1;
+        }
+
+        // Threads a fresh run of `cls` sized slots off the current chunk; requires `mutex`
+        node* carve(size_t cls);
+    };
+}  // namespace un::event
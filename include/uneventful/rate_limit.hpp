@@ -0,0 +1,112 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <event2/bufferevent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace un::event {
+    /** Token-bucket shape for a stream or a group of streams. Rates are in bytes per second, with 0
+        meaning unlimited; bursts cap how much may go in one go after an idle spell (0 defaults to
+        one second's worth). Buckets are refilled every `tick`, so a smaller tick gives smoother
+        traffic at the cost of more refills.
+     */
+    struct rate_limit {
+        size_t read_rate{0};
+        size_t read_burst{0};
+        size_t write_rate{0};
+        size_t write_burst{0};
+        std::chrono::milliseconds tick{50};
+    };
+
+    namespace detail {
+        struct token_bucket_deleter {
+            void operator()(ev_token_bucket_cfg* c) const noexcept { ev_token_bucket_cfg_free(c); }
+        };
+        using token_bucket_ptr = std::unique_ptr<ev_token_bucket_cfg, token_bucket_deleter>;
+
+        inline token_bucket_ptr make_token_bucket(const rate_limit& r) {
+            auto tick = std::max(r.tick, std::chrono::milliseconds{1});
+            auto per_tick = [&](size_t rate) -> size_t {
+                if (rate == 0) {
+                    return EV_RATE_LIMIT_MAX;
+                }
+                return std::clamp<size_t>(rate * tick.count() / 1000, 1, EV_RATE_LIMIT_MAX);
+            };
+            auto burst = [&](size_t rate, size_t b) -> size_t {
+                if (rate == 0) {
+                    return EV_RATE_LIMIT_MAX;
+                }
+                // libevent requires a bucket to hold at least one tick's refill
+                return std::clamp<size_t>(b ? b : rate, per_tick(rate), EV_RATE_LIMIT_MAX);
+            };
+
+            auto tv = loop_time_to_timeval(tick);
+            token_bucket_ptr cfg{ev_token_bucket_cfg_new(
+                    per_tick(r.read_rate),
+                    burst(r.read_rate, r.read_burst),
+                    per_tick(r.write_rate),
+                    burst(r.write_rate, r.write_burst),
+                    &tv)};
+            if (not cfg) {
+                throw std::invalid_argument{"Invalid rate limit"};
+            }
+            return cfg;
+        }
+    }  // namespace detail
+
+    /** A token bucket shared by any number of streams on one loop (libevent's
+        bufferevent_rate_limit_group): the members' combined traffic is held to the group's rate,
+        and a single refill timer serves the whole group however many streams join it. A stream may
+        have its own limit as well, in which case the stricter of the two applies.
+
+        Created with `unevent_loop::make_rate_limit_group`; members keep it alive. Must be used on
+        its loop's thread.
+     */
+    template <typename Loop>
+    class rate_limit_group {
+        std::weak_ptr<Loop> loop;
+        std::unique_ptr<bufferevent_rate_limit_group, void (*)(bufferevent_rate_limit_group*)> group{
+                nullptr, ::bufferevent_rate_limit_group_free};
+
+      public:
+        rate_limit_group(Loop& l, const rate_limit& r) : loop{l.weak_from_this()} {
+            auto cfg = detail::make_token_bucket(r);
+            // the group copies the configuration
+            group.reset(bufferevent_rate_limit_group_new(l.loop(), cfg.get()));
+            if (not group) {
+                throw std::runtime_error{"Failed to create rate limit group"};
+            }
+        }
+
+        ~rate_limit_group() {
+            detail::release_on_loop(loop, [this] { group.reset(); }, [this] { (void)group.release(); });
+        }
+
+        rate_limit_group(const rate_limit_group&) = delete;
+        rate_limit_group& operator=(const rate_limit_group&) = delete;
+
+        void set(const rate_limit& r) {
+            auto cfg = detail::make_token_bucket(r);
+            bufferevent_rate_limit_group_set_cfg(group.get(), cfg.get());
+        }
+
+        // Smallest share handed to any one member per tick, so a crowded group still makes progress
+        void set_min_share(size_t bytes) { bufferevent_rate_limit_group_set_min_share(group.get(), bytes); }
+
+        // Bytes read and written by all members since the group was created
+        std::pair<uint64_t, uint64_t> totals() const {
+            ev_uint64_t read{0}, written{0};
+            bufferevent_rate_limit_group_get_totals(group.get(), &read, &written);
+            return {read, written};
+        }
+
+        bufferevent_rate_limit_group* native() const noexcept { return group.get(); }
+    };
+}  // namespace un::event
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "trace.hpp"
+#include "utils.hpp"
+
+#include <event2/event.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace un::event {
+    namespace detail {
+        // Start of the shared mapping; the ring's bytes follow at `shm_data_offset`
+        struct shm_header {
+            uint64_t magic;
+            uint64_t capacity;
+            // bytes ever published by the writer and consumed by the reader; each on its own line so
+            // that the two processes only share a cache line when one actually reads the other's
+            alignas(64) std::atomic<uint64_t> head;
+            alignas(64) std::atomic<uint64_t> tail;
+            // set by a reader about to sleep on the eventfd; the writer that clears it owes a wakeup
+            alignas(64) std::atomic<uint32_t> waiting;
+        };
+
+        inline constexpr size_t shm_data_offset{4096};
+
+        static_assert(sizeof(shm_header) <= shm_data_offset);
+        static_assert(std::atomic<uint64_t>::is_always_lock_free);
+    }  // namespace detail
+
+    /** One direction of a shared-memory message channel between two processes: a ring of
+        length-prefixed messages in a memfd mapped by both sides, and an eventfd through which the
+        writer wakes the reader. `create` makes a new channel, `send_to` passes its descriptors over
+        a Unix socket (SCM_RIGHTS), and the peer maps the same ring with `receive`. For messages in
+        both directions, use two channels.
+
+        There is one writer and one reader, each on a single thread at a time. Messages are written
+        in place (`reserve`/`commit`, or `try_write`, which copies in) and read in place, so nothing
+        is copied through the kernel. Written messages become visible to the reader when published;
+        a publish only writes the eventfd if the reader has drained everything and gone to sleep,
+        so a writer that keeps ahead of its reader makes no syscalls at all.
+
+        The reading side is normally an `unevent_loop` watcher (see `shm_reader`); `read` and `arm`
+        are the pieces it is built from.
+     */
+    class shm_channel {
+        int memfd{-1};
+        int efd{-1};
+        detail::shm_header* hdr{nullptr};
+        std::byte* data{nullptr};
+        size_t map_size{0};
+        // validated once when mapped: the header is shared with the peer, which could rewrite it later
+        size_t ring_size{0};
+
+        // writer side: end of what has been written, published or not, and room held by `reserve`
+        uint64_t staged{0};
+        std::optional<size_t> reserved;
+        uint64_t notifies{0};
+
+        shm_channel(int memfd, int efd);
+
+        void close() noexcept;
+
+      public:
+        shm_channel() = default;
+
+        /** New channel whose ring holds `capacity` bytes (rounded up to a power of two, at least a
+            page). Each message takes its length plus 4 bytes, rounded up to 8.
+         */
+        static shm_channel create(size_t capacity);
+
+        // Maps the channel whose descriptors a peer's `send_to` passes over `sock`, waiting for them
+        static shm_channel receive(int sock);
+
+        shm_channel(const shm_channel&) = delete;
+        shm_channel& operator=(const shm_channel&) = delete;
+
+        shm_channel(shm_channel&& c) noexcept :
+                memfd{std::exchange(c.memfd, -1)},
+                efd{std::exchange(c.efd, -1)},
+                hdr{std::exchange(c.hdr, nullptr)},
+                data{std::exchange(c.data, nullptr)},
+                map_size{std::exchange(c.map_size, 0)},
+                ring_size{std::exchange(c.ring_size, 0)},
+                staged{c.staged},
+                reserved{std::exchange(c.reserved, std::nullopt)},
+                notifies{c.notifies} {}
+
+        shm_channel& operator=(shm_channel&& c) noexcept;
+
+        ~shm_channel() { close(); }
+
+        explicit operator bool() const noexcept { return hdr != nullptr; }
+
+        // Passes the memfd and eventfd to the process at the other end of the Unix socket `sock`
+        void send_to(int sock) const;
+
+        size_t capacity() const noexcept { return ring_size; }
+        // Largest message the ring can ever take
+        size_t max_message() const noexcept { return ring_size ? ring_size / 2 - 8 : 0; }
+
+        // -- writer --
+
+        /** Space for a message of up to `size` bytes, to be filled and then committed; empty if the
+            ring has no room for it right now. Throws std::length_error past `max_message()`.
+         */
+        std::span<std::byte> reserve(size_t size);
+        // Stages the reserved message, cut down to its first `size` bytes
+        void commit(size_t size);
+
+        // Copies `msg` into the ring and stages it; false if there is no room right now
+        bool try_write(std::string_view msg);
+
+        // Makes everything staged visible to the reader, waking it if it sleeps
+        void publish();
+
+        bool try_send(std::string_view msg) {
+            if (not try_write(msg)) {
+                return false;
+            }
+            publish();
+            return true;
+        }
+
+        // Times `publish` has written the eventfd
+        uint64_t notifications() const noexcept { return notifies; }
+
+        // -- reader --
+
+        /** Calls `f` with up to `max` published messages, each viewed in place and only valid during
+            its call, then releases their space to the writer. Returns the number read.
+         */
+        size_t read(const std::function<void(std::string_view)>& f, size_t max = SIZE_MAX);
+
+        /** Declares the reader about to sleep on `eventfd()`: true if there is nothing to read, so
+            that the next publish will wake it; false, with nothing declared, if messages arrived in
+            the meantime and must be read first.
+         */
+        bool arm();
+
+        // Clears pending wakeups from the eventfd
+        void drain_wakeups() const;
+
+        int eventfd() const noexcept { return efd; }
+        int native() const noexcept { return memfd; }
+    };
+
+    /** Reads an `shm_channel` on a loop: each wakeup drains the ring through the callback, up to
+        `max_batch` messages before yielding to the loop's other events, then goes back to sleep on
+        the eventfd only once the ring is empty. Messages are views into the ring, valid for the
+        duration of the callback.
+
+        Created with `unevent_loop::make_shm_reader`; it is only touched on the loop thread and
+        stops reading when destroyed. It does not keep its loop alive, and may outlive it.
+     */
+    template <typename Loop>
+    class shm_reader {
+      public:
+        using callback = std::function<void(std::string_view)>;
+
+      private:
+        std::weak_ptr<Loop> loop;
+        const std::atomic<trace_buffer*>& trace;
+        shm_channel channel;
+        callback cb;
+        const size_t max_batch;
+        uint64_t wakeup_count{0};
+        uint64_t message_count{0};
+        // declared last: freed before the channel it reads
+        std::unique_ptr<::event, void (*)(::event*)> ev{nullptr, ::event_free};
+
+        static void on_readable(evutil_socket_t, short, void* arg) { static_cast<shm_reader*>(arg)->dispatch(); }
+
+        void dispatch() {
+            detail::io_trace_scope traced{trace, "shm"};
+            ++wakeup_count;
+            channel.drain_wakeups();
+
+            size_t n{0};
+            for (;;) {
+                try {
+                    n += channel.read(
+                            [this](std::string_view msg) {
+                                try {
+                                    cb(msg);
+                                } catch (const std::exception& e) {
+                                    unlog::critical(Loop::log, "Shared memory reader caught exception: {}", e.what());
+                                }
+                            },
+                            max_batch - n);
+                } catch (const std::exception& e) {
+                    // the peer broke the ring; nothing after this point can be trusted, so stop reading
+                    unlog::critical(Loop::log, "Shared memory reader stopped: {}", e.what());
+                    event_del(ev.get());
+                    break;
+                }
+
+                if (n >= max_batch) {
+                    // more may be waiting: come back after the loop's other events without sleeping
+                    event_active(ev.get(), EV_READ, 0);
+                    break;
+                }
+                if (channel.arm()) {
+                    break;
+                }
+            }
+            message_count += n;
+        }
+
+      public:
+        shm_reader(Loop& l, shm_channel ch, callback f, size_t batch) :
+                loop{l.weak_from_this()},
+                trace{l.active_trace},
+                channel{std::move(ch)},
+                cb{std::move(f)},
+                max_batch{std::max<size_t>(batch, 1)} {
+            ev.reset(event_new(l.loop(), channel.eventfd(), EV_READ | EV_PERSIST, &shm_reader::on_readable, this));
+            if (not ev or event_add(ev.get(), nullptr) != 0) {
+                throw std::runtime_error{"Failed to watch shared memory channel"};
+            }
+            // picks up whatever was published before the reader existed
+            event_active(ev.get(), EV_READ, 0);
+        }
+
+        ~shm_reader() {
+            detail::release_on_loop(loop, [this] { ev.reset(); }, [this] { (void)ev.release(); });
+        }
+
+        shm_reader(const shm_reader&) = delete;
+        shm_reader& operator=(const shm_reader&) = delete;
+
+        // Times the reader woke up, and messages it has delivered
+        uint64_t wakeups() const noexcept { return wakeup_count; }
+        uint64_t messages() const noexcept { return message_count; }
+
+        const shm_channel& native() const noexcept { return channel; }
+    };
+}  // namespace un::event
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "trace.hpp"
+#include "utils.hpp"
+
+#include <event2/event.h>
+#include <signal.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <source_location>
+#include <utility>
+#include <vector>
+
+namespace un::event {
+    /** Blocks `signals` in the calling thread and in every loop and helper thread uneventful starts
+        afterwards. Signals watched through `unevent_loop::on_signal` must be blocked in every thread
+        of the process, or the kernel may deliver them to an unblocked thread instead of the loop;
+        call this from `main` before any other threads exist.
+     */
+    void block_signals(std::initializer_list<int> signals);
+
+    namespace detail {
+        // Adds `signo` to the set blocked by uneventful's threads and blocks it in the calling one
+        void block_signal(int signo);
+        // Blocks the process-wide set in the calling thread; run at the start of uneventful's threads
+        void block_watched_signals();
+
+        /** A loop's signalfd and its read event. Each signal may be watched by a single loop in the
+            process, so that process-directed signals always land on the same loop; a second loop
+            adding it gets std::logic_error.
+         */
+        class signal_fd {
+            int fd{-1};
+            sigset_t mask{};
+            std::array<uint32_t, NSIG> refs{};
+            std::unique_ptr<::event, void (*)(::event*)> ev{nullptr, ::event_free};
+
+            void release(int signo);
+
+          public:
+            signal_fd(event_base* base, event_callback_fn cb, void* arg);
+            ~signal_fd();
+
+            signal_fd(const signal_fd&) = delete;
+            signal_fd& operator=(const signal_fd&) = delete;
+
+            void add(int signo);
+            void remove(int signo);
+
+            // Reads every queued signal, adding one to `counts[signo]` per delivery
+            void read(std::array<uint32_t, NSIG>& counts);
+        };
+    }  // namespace detail
+
+    template <typename Loop>
+    class signal_watcher;
+
+    /** The signal watchers of one loop, multiplexed over a single signalfd. Everything queued when
+        the fd becomes readable is read in one pass, and each watcher is then called once with the
+        number of deliveries of its signal: a burst of SIGHUPs costs one callback. Standard signals
+        are already merged by the kernel while pending, so counts above one only arise for
+        real-time signals or deliveries that straddle the read.
+
+        Owned by its loop and only touched on the loop thread; `signal_watcher` handles unregister from any
+        thread through `call_get`. A watcher removed from inside a callback is not called again.
+     */
+    template <typename Loop>
+    class signal_set {
+        using callback = std::function<void(uint32_t)>;
+
+        struct entry {
+            int signo;
+            std::shared_ptr<callback> f;
+            std::source_location site;
+        };
+
+        Loop& loop;
+        std::weak_ptr<signal_set> weak_self;
+        std::map<uint64_t, entry> watchers;
+        uint64_t next_id{1};
+        detail::signal_fd fd;
+
+        template <auto&>
+        friend class unevent_loop;
+        friend class signal_watcher<Loop>;
+
+        static void on_readable(evutil_socket_t, short, void* arg) { static_cast<signal_set*>(arg)->dispatch(); }
+
+        void dispatch() {
+            detail::io_trace_scope traced{loop.active_trace, "signal"};
+
+            std::array<uint32_t, NSIG> counts{};
+            fd.read(counts);
+
+            std::vector<std::pair<uint64_t, uint32_t>> due;
+            for (auto& [id, e] : watchers) {
+                if (counts[e.signo]) {
+                    due.emplace_back(id, counts[e.signo]);
+                }
+            }
+
+            for (auto [id, n] : due) {
+                auto it = watchers.find(id);
+                if (it == watchers.end()) {
+                    continue;
+                }
+
+                // keep the callback alive even if it removes its own watcher
+                auto f = it->second.f;
+                try {
+                    (*f)(n);
+                } catch (const std::exception& e) {
+                    unlog::critical(Loop::log, "Signal watcher caught exception: {}", e.what());
+                }
+            }
+        }
+
+        void remove(uint64_t id) {
+            if (auto it = watchers.find(id); it != watchers.end()) {
+                fd.remove(it->second.signo);
+                watchers.erase(it);
+            }
+        }
+
+      public:
+        using watcher = signal_watcher<Loop>;
+
+        explicit signal_set(Loop& _loop) : loop{_loop}, fd{_loop.loop(), &signal_set::on_readable, this} {}
+
+        signal_set(const signal_set&) = delete;
+        signal_set& operator=(const signal_set&) = delete;
+
+        // Loop thread only
+        watcher add(int signo, callback f, std::source_location loc) {
+            fd.add(signo);
+            auto id = next_id++;
+            watchers.emplace(id, entry{signo, std::make_shared<callback>(std::move(f)), loc});
+            return watcher{weak_self, id};
+        }
+    };
+
+    // Registration made by `unevent_loop::on_signal`; unregisters on destruction or `reset`
+    template <typename Loop>
+    class signal_watcher {
+        friend class signal_set<Loop>;
+
+        std::weak_ptr<signal_set<Loop>> set;
+        uint64_t id{0};
+
+        signal_watcher(std::weak_ptr<signal_set<Loop>> s, uint64_t i) : set{std::move(s)}, id{i} {}
+
+      public:
+        signal_watcher() = default;
+        signal_watcher(const signal_watcher&) = delete;
+        signal_watcher& operator=(const signal_watcher&) = delete;
+
+        signal_watcher(signal_watcher&& w) noexcept : set{std::move(w.set)}, id{std::exchange(w.id, 0)} {}
+
+        signal_watcher& operator=(signal_watcher&& w) noexcept {
+            if (this != &w) {
+                reset();
+                set = std::move(w.set);
+                id = std::exchange(w.id, 0);
+            }
+            return *this;
+        }
+
+        ~signal_watcher() { reset(); }
+
+        explicit operator bool() const noexcept { return id != 0; }
+
+        void reset() {
+            if (id == 0) {
+                return;
+            }
+            if (auto s = set.lock()) {
+                s->loop.call_get([&] { s->remove(id); });
+            }
+            id = 0;
+            set.reset();
+        }
+    };
+}  // namespace un::event
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "rate_limit.hpp"
+#include "trace.hpp"
+#include "utils.hpp"
+
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace un::event {
+    /** A buffered, full-duplex byte stream over a connected socket (a libevent bufferevent) living
+        on one loop. Data is delivered through `on_data`, and `on_close` fires once when the peer
+        hangs up (empty error code) or the connection fails.
+
+        Streams are created with `unevent_loop::make_stream` and, apart from destruction, must only
+        be used on their loop's thread. They do not keep their loop alive; destroy them first.
+     */
+    template <typename Loop>
+    class stream {
+        std::weak_ptr<Loop> loop;
+        const std::atomic<trace_buffer*>& trace;
+        // declared ahead of `bev` so they are released after it
+        detail::token_bucket_ptr limit;
+        std::shared_ptr<rate_limit_group<Loop>> group;
+        std::unique_ptr<bufferevent, void (*)(bufferevent*)> bev{nullptr, ::bufferevent_free};
+
+        std::function<void(stream&)> data_cb;
+        std::function<void(stream&, std::error_code)> close_cb;
+        bool open{true};
+
+        static void read_cb(bufferevent*, void* arg) {
+            auto& s = *static_cast<stream*>(arg);
+            detail::io_trace_scope traced{s.trace, "stream"};
+            if (s.data_cb) {
+                try {
+                    s.data_cb(s);
+                } catch (const std::exception& e) {
+                    unlog::critical(Loop::log, "Stream data callback caught exception: {}", e.what());
+                }
+            }
+        }
+
+        // On the loop thread bufferevent_free only schedules the free, so take the bufferevent out of
+        // its group and off its limit first: either may be released right after, with the stream
+        void free_bev() {
+            if (group) {
+                bufferevent_remove_from_rate_limit_group(bev.get());
+            }
+            bufferevent_set_rate_limit(bev.get(), nullptr);
+            bev.reset();
+        }
+
+        static void event_cb(bufferevent* b, short what, void* arg) {
+            auto& s = *static_cast<stream*>(arg);
+            if (not (what & (BEV_EVENT_EOF | BEV_EVENT_ERROR))) {
+                return;
+            }
+            detail::io_trace_scope traced{s.trace, "stream"};
+
+            std::error_code ec{};
+            if (what & BEV_EVENT_ERROR) {
+                ec = std::error_code{EVUTIL_SOCKET_ERROR(), std::system_category()};
+            }
+            bufferevent_disable(b, EV_READ | EV_WRITE);
+            s.open = false;
+
+            if (auto f = std::move(s.close_cb)) {
+                try {
+                    f(s, ec);
+                } catch (const std::exception& e) {
+                    unlog::critical(Loop::log, "Stream close callback caught exception: {}", e.what());
+                }
+            }
+        }
+
+      public:
+        // Takes ownership of the connected socket `fd`
+        stream(Loop& l, evutil_socket_t fd) : loop{l.weak_from_this()}, trace{l.active_trace} {
+            evutil_make_socket_nonblocking(fd);
+            bev.reset(bufferevent_socket_new(l.loop(), fd, BEV_OPT_CLOSE_ON_FREE));
+            if (not bev) {
+                evutil_closesocket(fd);
+                throw std::runtime_error{"Failed to create stream"};
+            }
+            bufferevent_setcb(bev.get(), &stream::read_cb, nullptr, &stream::event_cb, this);
+            bufferevent_enable(bev.get(), EV_READ | EV_WRITE);
+        }
+
+        ~stream() {
+            detail::release_on_loop(loop, [this] { free_bev(); }, [this] {
+                (void)bev.release();
+                (void)limit.release();
+            });
+        }
+
+        stream(const stream&) = delete;
+        stream& operator=(const stream&) = delete;
+
+        void on_data(std::function<void(stream&)> f) { data_cb = std::move(f); }
+        void on_close(std::function<void(stream&, std::error_code)> f) { close_cb = std::move(f); }
+
+        bool is_open() const noexcept { return open; }
+
+        // Queues `data` for sending; false once the stream has closed
+        bool write(std::string_view data) {
+            return open and bufferevent_write(bev.get(), data.data(), data.size()) == 0;
+        }
+
+        // Bytes queued but not yet handed to the socket
+        size_t pending_output() const { return evbuffer_get_length(bufferevent_get_output(bev.get())); }
+
+        evbuffer* input() const { return bufferevent_get_input(bev.get()); }
+
+        // Removes and returns everything received so far
+        std::string read_all() {
+            auto* in = input();
+            std::string out(evbuffer_get_length(in), '\0');
+            evbuffer_remove(in, out.data(), out.size());
+            return out;
+        }
+
+        // Stops reading and writing; unsent output is discarded when the stream is destroyed
+        void close() {
+            bufferevent_disable(bev.get(), EV_READ | EV_WRITE);
+            open = false;
+        }
+
+        // Caps this stream on its own; replaces any earlier per-stream limit
+        void set_rate_limit(const rate_limit& r) {
+            auto cfg = detail::make_token_bucket(r);
+            // libevent keeps using the configuration it is given, so it must outlive the setting
+            bufferevent_set_rate_limit(bev.get(), cfg.get());
+            limit = std::move(cfg);
+        }
+
+        void clear_rate_limit() {
+            bufferevent_set_rate_limit(bev.get(), nullptr);
+            limit.reset();
+        }
+
+        // Moves the stream into `g`, leaving any group it was in before
+        void join(std::shared_ptr<rate_limit_group<Loop>> g) {
+            if (bufferevent_add_to_rate_limit_group(bev.get(), g->native()) != 0) {
+                throw std::runtime_error{"Failed to join rate limit group"};
+            }
+            group = std::move(g);
+        }
+
+        void leave_group() {
+            bufferevent_remove_from_rate_limit_group(bev.get());
+            group.reset();
+        }
+
+        bufferevent* native() const noexcept { return bev.get(); }
+    };
+}  // namespace un::event
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <source_location>
+#include <utility>
+#include <vector>
+
+namespace un::event {
+    /** A set of tickers sharing one interval, driven by a single underlying `ev_watcher`: one timer
+        heap entry and one wakeup per interval regardless of membership. Member callbacks live in a
+        contiguous array and are invoked in a tight loop; join and leave are O(1) (swap-and-pop
+        through a slot indirection table).
+
+        Created with `unevent_loop::make_ticker_group`; the group and its members do not keep their
+        loop alive and may outlive it, after which the group never ticks again and `join` returns an
+        empty member. All of its state is touched only on the loop thread; `join`, `size` and member
+        and group destruction from any other thread hop onto the loop with `call_get`. Membership
+        changes made from inside a member callback take effect once the current dispatch pass
+        completes, except that a member which leaves is never invoked again.
+     */
+    template <typename Loop>
+    class ticker_group {
+        using watcher_ptr = std::shared_ptr<typename Loop::ev_watcher>;
+
+        static constexpr uint32_t npos{std::numeric_limits<uint32_t>::max()};
+
+        struct entry {
+            std::function<void()> f;
+            uint32_t slot;
+            bool live{true};
+        };
+
+        std::weak_ptr<Loop> loop;
+        std::weak_ptr<ticker_group> weak_self;
+
+        std::vector<entry> members;
+        // slot -> index into `members`; npos for free slots and for joins deferred during dispatch
+        std::vector<uint32_t> slot_index;
+        std::vector<uint32_t> free_slots;
+
+        bool dispatching{false};
+        std::vector<entry> pending_joins;
+        std::vector<uint32_t> pending_leaves;
+
+        // declared last: destroyed (and its event freed) before anything it dispatches into
+        watcher_ptr watcher;
+
+      public:
+        // RAII membership; destroying (or resetting) the handle leaves the group
+        class member {
+            friend class ticker_group;
+
+            std::weak_ptr<ticker_group> group;
+            uint32_t slot{npos};
+
+            member(std::weak_ptr<ticker_group> g, uint32_t s) : group{std::move(g)}, slot{s} {}
+
+          public:
+            member() = default;
+            member(const member&) = delete;
+            member& operator=(const member&) = delete;
+
+            member(member&& m) noexcept : group{std::move(m.group)}, slot{std::exchange(m.slot, npos)} {}
+
+            member& operator=(member&& m) noexcept {
+                if (this != &m) {
+                    reset();
+                    group = std::move(m.group);
+                    slot = std::exchange(m.slot, npos);
+                }
+                return *this;
+            }
+
+            ~member() { reset(); }
+
+            explicit operator bool() const noexcept { return slot != npos; }
+
+            void reset() {
+                if (slot == npos) {
+                    return;
+                }
+                if (auto g = group.lock()) {
+                    // once the loop is gone nothing dispatches the group any more
+                    detail::release_on_loop(g->loop, [&] { g->leave(slot); }, [] {});
+                }
+                slot = npos;
+                group.reset();
+            }
+        };
+
+        ticker_group(Loop& _loop, std::chrono::microseconds interval, std::source_location loc) :
+                loop{_loop.weak_from_this()}, watcher{_loop.call_every(interval, [this] { dispatch(); }, false, loc)} {}
+
+        // the loop frees the watcher's event itself when it is destroyed first
+        ~ticker_group() {
+            detail::release_on_loop(loop, [this] { watcher.reset(); }, [this] { watcher.reset(); });
+        }
+
+        ticker_group(const ticker_group&) = delete;
+        ticker_group& operator=(const ticker_group&) = delete;
+
+        // Adds `f` to the group; it is first invoked on the next group tick
+        template <std::invocable Callable>
+        [[nodiscard]] member join(Callable&& f) {
+            auto l = loop.lock();
+            if (not l) {
+                return member{};
+            }
+            return l->call_get([&] {
+                auto slot = acquire_slot();
+                entry e{std::forward<Callable>(f), slot};
+
+                if (dispatching) {
+                    pending_joins.push_back(std::move(e));
+                }
+                else {
+                    insert(std::move(e));
+                }
+
+                return member{weak_self, slot};
+            });
+        }
+
+        // Number of members, including joins not yet merged into the dispatch array
+        size_t size() const {
+            auto count = [this] { return members.size() + pending_joins.size() - pending_leaves.size(); };
+            auto l = loop.lock();
+            return l ? l->call_get(count) : count();
+        }
+
+      private:
+        friend Loop;
+
+        uint32_t acquire_slot() {
+            if (not free_slots.empty()) {
+                auto s = free_slots.back();
+                free_slots.pop_back();
+                return s;
+            }
+            slot_index.push_back(npos);
+            return static_cast<uint32_t>(slot_index.size() - 1);
+        }
+
+        void insert(entry e) {
+            slot_index[e.slot] = static_cast<uint32_t>(members.size());
+            members.push_back(std::move(e));
+
+            if (members.size() == 1) {
+                watcher->start();
+            }
+        }
+
+        void erase(uint32_t slot) {
+            auto idx = slot_index[slot];
+            slot_index[slot] = npos;
+            free_slots.push_back(slot);
+
+            if (idx != static_cast<uint32_t>(members.size() - 1)) {
+                members[idx] = std::move(members.back());
+                slot_index[members[idx].slot] = idx;
+            }
+            members.pop_back();
+
+            if (members.empty()) {
+                watcher->stop();
+            }
+        }
+
+        void leave(uint32_t slot) {
+            if (slot_index[slot] == npos) {
+                // joined during the current dispatch pass and not merged yet
+                std::erase_if(pending_joins, [slot](const entry& e) { return e.slot == slot; });
+                free_slots.push_back(slot);
+                return;
+            }
+
+            if (dispatching) {
+                // keep the array (and a possibly still executing callback) intact under the dispatch
+                // loop; dead entries are skipped and erased once the pass completes
+                members[slot_index[slot]].live = false;
+                pending_leaves.push_back(slot);
+                return;
+            }
+
+            erase(slot);
+        }
+
+        void dispatch() {
+            // a member dropping the last reference to the group must not free it under this loop
+            auto self = weak_self.lock();
+            dispatching = true;
+
+            for (size_t i = 0, n = members.size(); i < n; ++i) {
+                if (members[i].live) {
+                    try {
+                        members[i].f();
+                    } catch (const std::exception& e) {
+                        unlog::critical(Loop::log, "Ticker group member caught exception: {}", e.what());
+                    }
+                }
+            }
+
+            dispatching = false;
+
+            for (auto slot : pending_leaves) {
+                erase(slot);
+            }
+            pending_leaves.clear();
+
+            for (auto& e : pending_joins) {
+                insert(std::move(e));
+            }
+            pending_joins.clear();
+        }
+    };
+}  // namespace un::event
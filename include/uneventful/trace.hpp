@@ -0,0 +1,123 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace un::event {
+    enum class trace_kind : uint8_t {
+        wakeup,  // a producer activated the job waker (instant, on the producer's thread)
+        drain,   // one process_job_queue pass; arg holds the number of jobs taken
+        job,     // a single queued job
+        timer,   // an ev_watcher callback
+        io,      // an I/O readiness callback; `file` names its source ("stream", "signal", ...)
+    };
+
+    struct trace_record {
+        uint64_t ts_ns{0};
+        uint64_t dur_ns{0};
+        uint64_t arg{0};
+        const char* file{nullptr};
+        uint32_t line{0};
+        uint32_t tid{0};
+        trace_kind kind{};
+    };
+
+    namespace detail {
+        // Small, stable per-thread id for trace records (the kernel tid on linux)
+        uint32_t thread_tag() noexcept;
+    }  // namespace detail
+
+    /** Fixed-capacity, overwrite-oldest ring of trace records. Any thread may emit; each slot is
+        guarded by a sequence word so a concurrent reader skips records that are mid-write instead
+        of blocking writers. Emitting is one relaxed fetch_add plus a handful of relaxed stores.
+     */
+    class trace_buffer {
+        struct slot {
+            std::atomic<uint64_t> seq{0};
+            std::atomic<uint64_t> ts_ns{0};
+            std::atomic<uint64_t> dur_ns{0};
+            std::atomic<uint64_t> arg{0};
+            std::atomic<const char*> file{nullptr};
+            std::atomic<uint64_t> line_tid_kind{0};
+        };
+
+        const size_t mask;
+        std::unique_ptr<slot[]> slots;
+        std::atomic<uint64_t> head{0};
+
+      public:
+        // `capacity` is rounded up to a power of two
+        explicit trace_buffer(size_t capacity) :
+                mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1}, slots{new slot[mask + 1]} {}
+
+        size_t capacity() const noexcept { return mask + 1; }
+
+        static uint64_t now_ns() noexcept {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 detail::get_time().time_since_epoch())
+                                                 .count());
+        }
+
+        void emit(trace_kind kind,
+                  uint64_t ts_ns,
+                  uint64_t dur_ns = 0,
+                  uint64_t arg = 0,
+                  const char* file = nullptr,
+                  uint32_t line = 0) noexcept {
+            auto i = head.fetch_add(1, std::memory_order_relaxed);
+            auto& s = slots[i & mask];
+
+            // odd sequence marks the slot as being written
+            s.seq.store(2 * i + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            s.ts_ns.store(ts_ns, std::memory_order_relaxed);
+            s.dur_ns.store(dur_ns, std::memory_order_relaxed);
+            s.arg.store(arg, std::memory_order_relaxed);
+            s.file.store(file, std::memory_order_relaxed);
+            s.line_tid_kind.store(
+                    (uint64_t{line} << 32) | (uint64_t{detail::thread_tag() & 0x00ff'ffff} << 8) |
+                            static_cast<uint8_t>(kind),
+                    std::memory_order_relaxed);
+
+            s.seq.store(2 * i + 2, std::memory_order_release);
+        }
+
+        // Consistent copy of every completed record still in the ring, oldest first
+        std::vector<trace_record> snapshot() const;
+
+        // Chrome trace event JSON (load in chrome://tracing or ui.perfetto.dev)
+        std::string to_chrome_json() const;
+    };
+
+    namespace detail {
+        /** Records the I/O callback running for its lifetime as a `trace_kind::io` event, if the loop
+            whose `active_trace` is given was tracing when it started.
+         */
+        class io_trace_scope {
+            trace_buffer* const buf;
+            const uint64_t started;
+            const char* const source;
+
+          public:
+            io_trace_scope(const std::atomic<trace_buffer*>& active, const char* _source) noexcept :
+                    buf{active.load(std::memory_order_acquire)},
+                    started{buf ? trace_buffer::now_ns() : 0},
+                    source{_source} {}
+
+            ~io_trace_scope() {
+                if (buf) {
+                    buf->emit(trace_kind::io, started, trace_buffer::now_ns() - started, 0, source);
+                }
+            }
+
+            io_trace_scope(const io_trace_scope&) = delete;
+            io_trace_scope& operator=(const io_trace_scope&) = delete;
+        };
+    }  // namespace detail
+}  // namespace un::event
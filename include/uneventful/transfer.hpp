@@ -0,0 +1,134 @@
+#pragma once
+
+#include "trace.hpp"
+#include "utils.hpp"
+
+#include <event2/event.h>
+#include <sys/types.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+
+namespace un::event {
+    struct transfer_options {
+        // most bytes moved per writable notification before yielding to the loop's other events
+        size_t slice{4U << 20};
+        // go through a pipe with splice(2) even where sendfile(2) would work
+        bool splice{false};
+    };
+
+    /** The transfers running on a loop's base. The loop cancels whatever is left when it is
+        destroyed, so that no transfer keeps itself alive, watching an event on a freed base.
+     */
+    class transfer_registry {
+      public:
+        transfer_registry() = default;
+
+        transfer_registry(const transfer_registry&) = delete;
+        transfer_registry& operator=(const transfer_registry&) = delete;
+
+        // Cancels every transfer still running and releases its event; the base must still exist
+        void cancel_all();
+
+      private:
+        friend class file_transfer;
+
+        // transfers may also be started off the loop thread once it has shut down
+        std::mutex mutex;
+        detail::tracked_op* head{nullptr};
+    };
+
+    /** Zero-copy stream of a file range to a non-blocking socket, driven by the loop it was started
+        on (see `unevent_loop::send_file`). Data moves with sendfile(2), or with splice(2) through a
+        private pipe when the source does not support sendfile, without passing through user space.
+
+        The socket is watched for writability edge-triggered when the base supports it: each
+        notification moves data until the socket would block (EAGAIN) or `slice` bytes have gone,
+        in which case the transfer reschedules itself behind the loop's other pending events.
+
+        The transfer keeps itself alive until it finishes, or until its loop is destroyed, which
+        cancels it; the returned handle is only needed to inspect progress or `cancel()`. All members
+        must be used on the loop thread. Neither fd is closed by the transfer.
+     */
+    class file_transfer : detail::tracked_op {
+        friend class transfer_registry;
+
+      public:
+        // Called once with the outcome and the number of bytes written to the socket
+        using completion = std::move_only_function<void(std::error_code, size_t)>;
+
+        // Unlimited `count`: transfer until the end of the file
+        static constexpr size_t to_end{static_cast<size_t>(-1)};
+
+        /** Starts streaming `count` bytes of `in_fd` from `offset` to `out_fd`, listed in `registry`
+            until it finishes. Reaching the end of the file early is not an error: `done` then reports
+            fewer bytes. Throws std::runtime_error if the write event cannot be created. Writable
+            notifications are traced into `trace` while it is set.
+         */
+        static std::shared_ptr<file_transfer> start(
+                event_base* base,
+                transfer_registry& registry,
+                const std::atomic<trace_buffer*>& trace,
+                int out_fd,
+                int in_fd,
+                off_t offset,
+                size_t count,
+                completion done,
+                const transfer_options& opts = {});
+
+        ~file_transfer();
+
+        file_transfer(const file_transfer&) = delete;
+        file_transfer& operator=(const file_transfer&) = delete;
+
+        size_t sent() const noexcept { return bytes_sent; }
+
+        bool finished() const noexcept { return not self; }
+
+        // Stops the transfer; `done` receives std::errc::operation_canceled
+        void cancel();
+
+      private:
+        file_transfer(
+                const std::atomic<trace_buffer*>& trace,
+                int out_fd,
+                int in_fd,
+                off_t offset,
+                size_t count,
+                completion done,
+                const transfer_options& opts);
+
+        static void on_writable(evutil_socket_t, short, void* arg);
+        static void abandon(detail::tracked_op* op) noexcept;
+
+        void pump();
+        // Moves up to `want` bytes; returns what moved, 0 at end of file, or -1 with errno set
+        ssize_t move_sendfile(size_t want);
+        ssize_t move_splice(size_t want);
+        bool open_pipe();
+        void finish(std::error_code ec);
+
+        std::unique_ptr<::event, void (*)(::event*)> ev{nullptr, ::event_free};
+        // held while running, so that the transfer outlives every handle the caller drops
+        std::shared_ptr<file_transfer> self;
+        transfer_registry* registry{nullptr};
+        const std::atomic<trace_buffer*>& trace;
+
+        const int out;
+        const int in;
+        off_t offset;
+        size_t remaining;
+        size_t bytes_sent{0};
+        const size_t slice;
+
+        bool use_splice;
+        int pipe_r{-1};
+        int pipe_w{-1};
+        // bytes sitting in the pipe, already read from the file but not yet sent
+        size_t piped{0};
+
+        completion done;
+    };
+}  // namespace un::event
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <span>
 
 namespace un::event {
@@ -17,6 +18,21 @@ namespace un::event {
 
     inline constexpr size_t thread_bufsize_bytes{1U << 22};
 
+#ifndef UNEVENT_LOG_MIN_LEVEL
+#define UNEVENT_LOG_MIN_LEVEL 0
+#endif
+
+    /** Compile-time floor for log statements on the loop's hot paths (job waker, job queue drain,
+        busy-poll parking): 0 = trace, 1 = debug, 2 = info. Statements below the floor are discarded
+        by `if constexpr` and cost nothing, not even the channel's runtime level check. Set through
+        the UNEVENT_LOG_MIN_LEVEL CMake option; release configurations default to info.
+     */
+    inline constexpr int log_min_level{UNEVENT_LOG_MIN_LEVEL};
+
+    namespace detail {
+        inline constexpr bool hot_trace_enabled{log_min_level <= 0};
+    }  // namespace detail
+
     inline timeval loop_time_to_timeval(std::chrono::microseconds t) {
         return timeval{
                 .tv_sec = static_cast<decltype(timeval::tv_sec)>(t / 1s),
@@ -27,6 +43,75 @@ namespace un::event {
         inline std::chrono::steady_clock::time_point get_time() {
             return std::chrono::steady_clock::now();
         }
+
+        /** Work armed on a loop's event base by an object the loop does not own, linked into the loop
+            (`unevent_loop::track`) for as long as it is armed. If the loop shuts down first, it
+            unlinks the operation and calls `stop` on the loop thread, which must disarm it and
+            complete it as cancelled before the base goes away.
+         */
+        struct tracked_op {
+            tracked_op* prev{nullptr};
+            tracked_op* next{nullptr};
+            void (*stop)(tracked_op*) noexcept {nullptr};
+
+            void link(tracked_op*& head) noexcept {
+                prev = nullptr;
+                next = head;
+                if (head) {
+                    head->prev = this;
+                }
+                head = this;
+            }
+
+            // No-op if this operation is not on the list
+            void unlink(tracked_op*& head) noexcept {
+                if (not prev and head != this) {
+                    return;
+                }
+                (prev ? prev->next : head) = next;
+                if (next) {
+                    next->prev = prev;
+                }
+                prev = next = nullptr;
+            }
+        };
+
+        // The loop whose thread this is. Compared by owner, it still names that loop after its last
+        // owner has gone, while the destructor has yet to stop the thread.
+        inline thread_local std::weak_ptr<const void> thread_loop;
+
+        /** Destructor body for objects holding libevent state bound to the base of `loop`: `release`
+            frees that state on the loop thread, waiting there if need be. Once the loop is gone its
+            base went with it and there is nothing left to free the state from, so `forget` just gives
+            it up instead; unless this is the loop's own thread, which keeps running events on the
+            base until the loop's destructor stops it.
+         */
+        template <typename Loop, typename Release, typename Forget>
+        void release_on_loop(const std::weak_ptr<Loop>& loop, Release&& release, Forget&& forget) {
+            if (auto l = loop.lock(); not l) {
+                if (not thread_loop.owner_before(loop) and not loop.owner_before(thread_loop)) {
+                    release();
+                }
+                else {
+                    forget();
+                }
+            }
+            else if (l->in_event_loop()) {
+                release();
+            }
+            else {
+                l->call_get(release);
+            }
+        }
+
+        // Spin-wait hint; lets the sibling hyperthread run and saves power while busy-polling
+        inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            asm volatile("yield" ::: "memory");
+#endif
+        }
     }  // namespace detail
 
 }  // namespace un::event
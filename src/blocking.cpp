@@ -0,0 +1,166 @@
+#include "uneventful/blocking.hpp"
+#include "uneventful/signal.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+namespace un::event {
+    namespace {
+        // set on a helper thread whose task destroyed the pool; its worker loop must not touch the pool again
+        thread_local bool orphaned{false};
+    }  // namespace
+
+    blocking_pool::blocking_pool(size_t max_threads) : max_size{std::max<size_t>(max_threads, 1)} {}
+
+    blocking_pool::~blocking_pool() {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        cv.notify_all();
+
+        for (auto& t : workers) {
+            // destroyed by one of its own tasks, e.g. one holding the last reference to a loop
+            if (t.get_id() == std::this_thread::get_id()) {
+                orphaned = true;
+                t.detach();
+            }
+            else {
+                t.join();
+            }
+        }
+    }
+
+    void blocking_pool::submit(task t) {
+        {
+            std::lock_guard lock{mutex};
+            tasks.push_back(std::move(t));
+
+            if (tasks.size() > idle and workers.size() < max_size) {
+                workers.emplace_back([this] { work(); });
+                return;
+            }
+        }
+        cv.notify_one();
+    }
+
+    size_t blocking_pool::threads() const {
+        std::lock_guard lock{mutex};
+        return workers.size();
+    }
+
+    blocking_pool& blocking_pool::shared() {
+        static blocking_pool pool{std::clamp<size_t>(std::thread::hardware_concurrency(), 4, 16)};
+        return pool;
+    }
+
+    void blocking_pool::work() {
+        detail::block_watched_signals();
+
+        std::unique_lock lock{mutex};
+
+        for (;;) {
+            ++idle;
+            cv.wait(lock, [this] { return stopping or not tasks.empty(); });
+            --idle;
+
+            if (tasks.empty()) {
+                return;
+            }
+
+            auto t = std::move(tasks.front());
+            tasks.pop_front();
+
+            lock.unlock();
+            t();
+            // destroy whatever the task captured before retaking the lock
+            t = nullptr;
+            if (orphaned) {
+                return;
+            }
+            lock.lock();
+        }
+    }
+
+    namespace detail {
+        namespace {
+            struct fd_guard {
+                int fd;
+                ~fd_guard() {
+                    if (fd >= 0) {
+                        ::close(fd);
+                    }
+                }
+            };
+
+            [[noreturn]] void throw_errno(const char* what, const std::filesystem::path& path) {
+                throw std::system_error{errno, std::system_category(), std::string{what} + " " + path.string()};
+            }
+        }  // namespace
+
+        std::string read_whole_file(const std::filesystem::path& path) {
+            fd_guard f{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (f.fd < 0) {
+                throw_errno("Failed to open", path);
+            }
+
+            struct stat st{};
+            if (::fstat(f.fd, &st) != 0) {
+                throw_errno("Failed to stat", path);
+            }
+
+            // st_size is only a hint (procfs reports 0); keep reading until EOF
+            std::string out;
+            out.resize(std::max<size_t>(static_cast<size_t>(st.st_size), 4096));
+            size_t len{0};
+
+            for (;;) {
+                if (len == out.size()) {
+                    out.resize(out.size() * 2);
+                }
+                auto n = ::read(f.fd, out.data() + len, out.size() - len);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw_errno("Failed to read", path);
+                }
+                if (n == 0) {
+                    break;
+                }
+                len += static_cast<size_t>(n);
+            }
+
+            out.resize(len);
+            return out;
+        }
+
+        void write_whole_file(const std::filesystem::path& path, std::string_view data, bool append, bool sync) {
+            auto flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+            fd_guard f{::open(path.c_str(), flags, 0644)};
+            if (f.fd < 0) {
+                throw_errno("Failed to open", path);
+            }
+
+            while (not data.empty()) {
+                auto n = ::write(f.fd, data.data(), data.size());
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw_errno("Failed to write", path);
+                }
+                data.remove_prefix(static_cast<size_t>(n));
+            }
+
+            if (sync and ::fsync(f.fd) != 0) {
+                throw_errno("Failed to fsync", path);
+            }
+        }
+    }  // namespace detail
+}  // namespace un::event
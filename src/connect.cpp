@@ -0,0 +1,237 @@
+#include "uneventful/connect.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace un::event {
+
+    namespace {
+        std::vector<sock_address> lookup(const std::string& host, uint16_t port, int flags, int* rv) {
+            evutil_addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_protocol = IPPROTO_TCP;
+            hints.ai_flags = flags | EVUTIL_AI_NUMERICSERV;
+
+            auto service = std::to_string(port);
+            evutil_addrinfo* res{nullptr};
+            *rv = evutil_getaddrinfo(host.c_str(), service.c_str(), &hints, &res);
+
+            std::vector<sock_address> out;
+            if (*rv != 0) {
+                return out;
+            }
+
+            for (auto* ai = res; ai; ai = ai->ai_next) {
+                if (ai->ai_addrlen > sizeof(sockaddr_storage)) {
+                    continue;
+                }
+                auto& a = out.emplace_back();
+                std::memcpy(&a.addr, ai->ai_addr, ai->ai_addrlen);
+                a.len = static_cast<socklen_t>(ai->ai_addrlen);
+            }
+            evutil_freeaddrinfo(res);
+
+            return out;
+        }
+
+        // Alternates families, keeping the first address's family first and each family's own order
+        void interleave(std::vector<sock_address>& addrs) {
+            if (addrs.empty()) {
+                return;
+            }
+
+            auto first = addrs.front().family();
+            std::vector<sock_address> primary, secondary;
+            for (auto& a : addrs) {
+                (a.family() == first ? primary : secondary).push_back(a);
+            }
+
+            addrs.clear();
+            for (size_t i = 0; i < std::max(primary.size(), secondary.size()); ++i) {
+                if (i < primary.size()) {
+                    addrs.push_back(primary[i]);
+                }
+                if (i < secondary.size()) {
+                    addrs.push_back(secondary[i]);
+                }
+            }
+        }
+    }  // namespace
+
+    std::vector<sock_address> numeric_addresses(const std::string& host, uint16_t port) {
+        int rv{0};
+        return lookup(host, port, EVUTIL_AI_NUMERICHOST, &rv);
+    }
+
+    std::vector<sock_address> resolve_addresses(const std::string& host, uint16_t port) {
+        int rv{0};
+        auto out = lookup(host, port, EVUTIL_AI_ADDRCONFIG, &rv);
+        if (rv != 0) {
+            throw std::system_error{
+                    std::make_error_code(std::errc::host_unreachable),
+                    "Failed to resolve " + host + ": " + evutil_gai_strerror(rv)};
+        }
+        return out;
+    }
+
+    tcp_connect::tcp_connect(std::vector<sock_address> a, completion d, const connect_options& opts) :
+            addrs{std::move(a)},
+            attempt_delay{std::max(opts.attempt_delay, std::chrono::milliseconds{1})},
+            timeout{opts.timeout},
+            done{std::move(d)} {
+        interleave(addrs);
+    }
+
+    tcp_connect::~tcp_connect() {
+        for (auto& a : attempts) {
+            a.ev.reset();
+            evutil_closesocket(a.fd);
+        }
+    }
+
+    std::shared_ptr<tcp_connect> tcp_connect::start(
+            event_base* base, std::vector<sock_address> addrs, completion done, const connect_options& opts) {
+        if (addrs.empty()) {
+            throw std::invalid_argument{"No addresses to connect to"};
+        }
+
+        auto c = std::shared_ptr<tcp_connect>{new tcp_connect{std::move(addrs), std::move(done), opts}};
+        c->base = base;
+
+        c->next_ev.reset(evtimer_new(base, &tcp_connect::on_next, c.get()));
+        c->timeout_ev.reset(evtimer_new(base, &tcp_connect::on_timeout, c.get()));
+        if (not c->next_ev or not c->timeout_ev) {
+            throw std::runtime_error{"Failed to create connect events"};
+        }
+
+        if (c->timeout > 0ms) {
+            auto tv = loop_time_to_timeval(c->timeout);
+            evtimer_add(c->timeout_ev.get(), &tv);
+        }
+
+        c->self = c;
+
+        // the first attempt starts from the loop, so `done` never runs before the caller has the handle
+        event_active(c->next_ev.get(), EV_TIMEOUT, 0);
+
+        return c;
+    }
+
+    void tcp_connect::cancel() {
+        if (self) {
+            finish(std::make_error_code(std::errc::operation_canceled));
+        }
+    }
+
+    void tcp_connect::on_writable(evutil_socket_t fd, short, void* arg) {
+        auto* c = static_cast<tcp_connect*>(arg);
+        if (not c->self) {
+            return;
+        }
+
+        int err{0};
+        socklen_t len = sizeof(err);
+        if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) {
+            err = errno;
+        }
+
+        if (err == 0) {
+            c->finish({}, fd);
+            return;
+        }
+
+        c->last_error = std::error_code{err, std::system_category()};
+        c->drop(fd);
+        // no point letting the next address wait out the delay behind a failure
+        c->launch();
+    }
+
+    void tcp_connect::on_next(evutil_socket_t, short, void* arg) {
+        auto* c = static_cast<tcp_connect*>(arg);
+        if (c->self) {
+            c->launch();
+        }
+    }
+
+    void tcp_connect::on_timeout(evutil_socket_t, short, void* arg) {
+        auto* c = static_cast<tcp_connect*>(arg);
+        if (c->self) {
+            c->finish(std::make_error_code(std::errc::timed_out));
+        }
+    }
+
+    void tcp_connect::launch() {
+        while (next < addrs.size()) {
+            auto& a = addrs[next++];
+
+            evutil_socket_t fd = ::socket(a.family(), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+            if (fd < 0) {
+                last_error = std::error_code{errno, std::system_category()};
+                continue;
+            }
+
+            if (::connect(fd, reinterpret_cast<const sockaddr*>(&a.addr), a.len) != 0 and errno != EINPROGRESS) {
+                last_error = std::error_code{errno, std::system_category()};
+                evutil_closesocket(fd);
+                continue;
+            }
+
+            // writable once the connect has resolved either way, including one that already has
+            auto& at = attempts.emplace_back(attempt{fd});
+            at.ev.reset(event_new(base, fd, EV_WRITE, &tcp_connect::on_writable, this));
+            if (not at.ev or event_add(at.ev.get(), nullptr) != 0) {
+                last_error = std::make_error_code(std::errc::not_enough_memory);
+                drop(fd);
+                continue;
+            }
+
+            if (next < addrs.size()) {
+                auto tv = loop_time_to_timeval(attempt_delay);
+                evtimer_add(next_ev.get(), &tv);
+            }
+            return;
+        }
+
+        if (attempts.empty()) {
+            finish(last_error);
+        }
+    }
+
+    void tcp_connect::drop(evutil_socket_t fd) {
+        auto it = std::ranges::find(attempts, fd, &attempt::fd);
+        if (it != attempts.end()) {
+            // remove the event before its fd goes away
+            attempts.erase(it);
+            evutil_closesocket(fd);
+        }
+    }
+
+    void tcp_connect::finish(std::error_code ec, evutil_socket_t fd) {
+        // may drop the last reference; stay alive until done has been called
+        auto keep = std::move(self);
+
+        event_del(next_ev.get());
+        event_del(timeout_ev.get());
+
+        // the winner is handed over; every other attempt is abandoned
+        for (auto& a : attempts) {
+            a.ev.reset();
+            if (a.fd != fd) {
+                evutil_closesocket(a.fd);
+            }
+        }
+        attempts.clear();
+
+        if (done) {
+            std::exchange(done, nullptr)(ec, fd);
+        }
+    }
+}  // namespace un::event
@@ -0,0 +1,195 @@
+#include "uneventful/dns.hpp"
+
+#include <netinet/in.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace un::event {
+
+    namespace {
+        struct dns_error_category final : std::error_category {
+            const char* name() const noexcept override { return "dns"; }
+            std::string message(int err) const override { return evdns_err_to_string(err); }
+        };
+    }  // namespace
+
+    const std::error_category& dns_category() noexcept {
+        static const dns_error_category category;
+        return category;
+    }
+
+    std::optional<dns_result> dns_cache::lookup(std::string_view host) {
+        auto now = detail::get_time();
+
+        std::lock_guard lock{mutex};
+        auto it = entries.find(host);
+        if (it == entries.end() or it->second.expires <= now) {
+            ++counters.misses;
+            return std::nullopt;
+        }
+
+        if (it->second.error) {
+            ++counters.negative_hits;
+            return std::unexpected{it->second.error};
+        }
+        ++counters.hits;
+        return it->second.addrs;
+    }
+
+    void dns_cache::store(std::string_view host, std::vector<sock_address> addrs, std::chrono::seconds ttl) {
+        ttl = std::clamp(ttl, opts.min_ttl, opts.max_ttl);
+        if (ttl <= 0s) {
+            return;
+        }
+
+        auto now = detail::get_time();
+        std::lock_guard lock{mutex};
+        make_room(now);
+        auto& e = entries[std::string{host}];
+        e.addrs = std::move(addrs);
+        e.error = {};
+        e.expires = now + ttl;
+    }
+
+    void dns_cache::store_negative(std::string_view host, std::error_code ec) {
+        if (opts.negative_ttl <= 0s) {
+            return;
+        }
+
+        auto now = detail::get_time();
+        std::lock_guard lock{mutex};
+        make_room(now);
+        auto& e = entries[std::string{host}];
+        e.addrs.clear();
+        e.error = ec;
+        e.expires = now + opts.negative_ttl;
+    }
+
+    void dns_cache::make_room(std::chrono::steady_clock::time_point now) {
+        if (entries.size() < opts.max_entries) {
+            return;
+        }
+
+        std::erase_if(entries, [now](const auto& kv) { return kv.second.expires <= now; });
+
+        while (not entries.empty() and entries.size() >= opts.max_entries) {
+            entries.erase(std::ranges::min_element(entries, {}, [](const auto& kv) { return kv.second.expires; }));
+        }
+    }
+
+    void dns_cache::clear() {
+        std::lock_guard lock{mutex};
+        entries.clear();
+    }
+
+    dns_cache_stats dns_cache::stats() const {
+        std::lock_guard lock{mutex};
+        auto st = counters;
+        st.entries = entries.size();
+        return st;
+    }
+
+    namespace detail {
+        std::string normalize_host(std::string_view host) {
+            std::string out{host};
+            std::ranges::transform(out, out.begin(), [](unsigned char c) { return std::tolower(c); });
+            // "example.com." and "example.com" are the same name
+            if (out.size() > 1 and out.back() == '.') {
+                out.pop_back();
+            }
+            return out;
+        }
+
+        hosts_table load_hosts(const std::string& path) {
+            hosts_table table;
+            std::ifstream in{path};
+
+            for (std::string line; std::getline(in, line);) {
+                if (auto hash = line.find('#'); hash != std::string::npos) {
+                    line.resize(hash);
+                }
+
+                std::istringstream fields{line};
+                std::string addr;
+                if (not (fields >> addr)) {
+                    continue;
+                }
+
+                auto parsed = numeric_addresses(addr, 0);
+                if (parsed.empty()) {
+                    continue;
+                }
+
+                for (std::string name; fields >> name;) {
+                    auto& v = table[normalize_host(name)];
+                    v.insert(v.end(), parsed.begin(), parsed.end());
+                }
+            }
+
+            return table;
+        }
+
+        evdns_base* make_evdns_base(event_base* base, const dns_options& opts) {
+            // don't keep the resolver's socket registered with the loop while nothing is in flight
+            auto* dns = evdns_base_new(base, EVDNS_BASE_DISABLE_WHEN_INACTIVE);
+            if (not dns) {
+                throw std::runtime_error{"Failed to create DNS resolver"};
+            }
+
+            if (opts.nameservers.empty()) {
+                // the hosts file is handled by the resolver itself, ahead of the cache
+                evdns_base_resolv_conf_parse(dns, DNS_OPTIONS_ALL & ~DNS_OPTION_HOSTSFILE, opts.resolv_conf.c_str());
+            }
+            else {
+                for (const auto& ns : opts.nameservers) {
+                    if (evdns_base_nameserver_ip_add(dns, ns.c_str()) != 0) {
+                        evdns_base_free(dns, 0);
+                        throw std::invalid_argument{"Invalid nameserver: " + ns};
+                    }
+                }
+            }
+
+            auto timeout = std::to_string(opts.timeout.count() / 1000.0);
+            auto attempts = std::to_string(std::max(opts.attempts, 1));
+            evdns_base_set_option(dns, "timeout:", timeout.c_str());
+            evdns_base_set_option(dns, "attempts:", attempts.c_str());
+
+            return dns;
+        }
+
+        std::vector<sock_address> with_port(std::vector<sock_address> addrs, uint16_t port) {
+            for (auto& a : addrs) {
+                if (a.family() == AF_INET6) {
+                    reinterpret_cast<sockaddr_in6*>(&a.addr)->sin6_port = htons(port);
+                }
+                else {
+                    reinterpret_cast<sockaddr_in*>(&a.addr)->sin_port = htons(port);
+                }
+            }
+            return addrs;
+        }
+
+        void append_answer(std::vector<sock_address>& out, char type, int count, const void* addresses) {
+            for (int i = 0; i < count; ++i) {
+                auto& a = out.emplace_back();
+                if (type == DNS_IPv6_AAAA) {
+                    auto* sin6 = reinterpret_cast<sockaddr_in6*>(&a.addr);
+                    sin6->sin6_family = AF_INET6;
+                    std::memcpy(&sin6->sin6_addr, static_cast<const in6_addr*>(addresses) + i, sizeof(in6_addr));
+                    a.len = sizeof(sockaddr_in6);
+                }
+                else {
+                    auto* sin = reinterpret_cast<sockaddr_in*>(&a.addr);
+                    sin->sin_family = AF_INET;
+                    std::memcpy(&sin->sin_addr, static_cast<const uint32_t*>(addresses) + i, sizeof(uint32_t));
+                    a.len = sizeof(sockaddr_in);
+                }
+            }
+        }
+    }  // namespace detail
+}  // namespace un::event
@@ -0,0 +1,254 @@
+#include "uneventful/http.hpp"
+
+#include "uneventful/connect.hpp"
+
+#include <event2/bufferevent.h>
+#include <event2/listener.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace un::event {
+
+    namespace {
+        constexpr int all_methods = EVHTTP_REQ_GET | EVHTTP_REQ_POST | EVHTTP_REQ_HEAD | EVHTTP_REQ_PUT |
+                                    EVHTTP_REQ_DELETE | EVHTTP_REQ_OPTIONS | EVHTTP_REQ_TRACE | EVHTTP_REQ_CONNECT |
+                                    EVHTTP_REQ_PATCH;
+
+        void release_owner(const void*, size_t, void* arg) {
+            delete static_cast<std::shared_ptr<const void>*>(arg);
+        }
+
+        // Appends `data` to `buf` by reference, holding `owner` until libevent lets go of the bytes
+        void add_reference(evbuffer* buf, std::string_view data, std::shared_ptr<const void> owner) {
+            if (data.empty()) {
+                return;
+            }
+
+            auto* keep = owner ? new std::shared_ptr<const void>{std::move(owner)} : nullptr;
+            if (evbuffer_add_reference(buf, data.data(), data.size(), keep ? &release_owner : nullptr, keep) != 0) {
+                delete keep;
+                throw std::runtime_error{"Failed to reference response data"};
+            }
+        }
+
+        // Sends an unanswered request's fallback response; evhttp frees the request once it is out
+        void abandon(evhttp_request* req, bool streaming) {
+            if (streaming) {
+                evhttp_send_reply_end(req);
+            }
+            else {
+                evhttp_send_reply(req, HTTP_INTERNAL, nullptr, nullptr);
+            }
+        }
+    }  // namespace
+
+    http_request& http_request::operator=(http_request&& r) noexcept {
+        if (this != &r) {
+            if (req) {
+                abandon(req, streaming);
+            }
+            req = std::exchange(r.req, nullptr);
+            streaming = std::exchange(r.streaming, false);
+        }
+        return *this;
+    }
+
+    http_request::~http_request() {
+        if (req) {
+            abandon(req, streaming);
+        }
+    }
+
+    evhttp_request* http_request::pending() const {
+        if (not req) {
+            throw std::logic_error{"HTTP request has already been answered"};
+        }
+        return req;
+    }
+
+    evhttp_request* http_request::unstarted() const {
+        auto* r = pending();
+        if (streaming) {
+            throw std::logic_error{"HTTP response is streaming; finish it with end()"};
+        }
+        return r;
+    }
+
+    evhttp_request* http_request::started() const {
+        auto* r = pending();
+        if (not streaming) {
+            throw std::logic_error{"HTTP response has not been started"};
+        }
+        return r;
+    }
+
+    evhttp_cmd_type http_request::method() const { return evhttp_request_get_command(pending()); }
+
+    std::string_view http_request::path() const {
+        const auto* uri = evhttp_request_get_evhttp_uri(pending());
+        const char* p = uri ? evhttp_uri_get_path(uri) : nullptr;
+        return p ? p : "";
+    }
+
+    std::string_view http_request::query() const {
+        const auto* uri = evhttp_request_get_evhttp_uri(pending());
+        const char* q = uri ? evhttp_uri_get_query(uri) : nullptr;
+        return q ? q : "";
+    }
+
+    std::optional<std::string_view> http_request::header(const char* name) const {
+        if (const char* v = evhttp_find_header(evhttp_request_get_input_headers(pending()), name)) {
+            return v;
+        }
+        return std::nullopt;
+    }
+
+    std::string_view http_request::body() const {
+        auto* in = evhttp_request_get_input_buffer(pending());
+        auto n = evbuffer_get_length(in);
+        if (n == 0) {
+            return {};
+        }
+        return {reinterpret_cast<const char*>(evbuffer_pullup(in, -1)), n};
+    }
+
+    evbuffer* http_request::input() const { return evhttp_request_get_input_buffer(pending()); }
+
+    bool http_request::connected() const { return req and evhttp_request_get_connection(req) != nullptr; }
+
+    size_t http_request::pending_output() const {
+        auto* conn = req ? evhttp_request_get_connection(req) : nullptr;
+        if (not conn) {
+            return 0;
+        }
+        return evbuffer_get_length(bufferevent_get_output(evhttp_connection_get_bufferevent(conn)));
+    }
+
+    void http_request::add_header(const char* name, const char* value) {
+        auto* r = unstarted();
+        if (evhttp_add_header(evhttp_request_get_output_headers(r), name, value) != 0) {
+            throw std::invalid_argument{"Invalid HTTP header"};
+        }
+    }
+
+    void http_request::reply(int code, std::string_view body) {
+        auto* r = unstarted();
+        // the request's own output buffer, rather than a temporary one, carries the body
+        evbuffer_add(evhttp_request_get_output_buffer(r), body.data(), body.size());
+        req = nullptr;
+        evhttp_send_reply(r, code, nullptr, nullptr);
+    }
+
+    void http_request::reply(int code, evbuffer* body) {
+        auto* r = unstarted();
+        req = nullptr;
+        evhttp_send_reply(r, code, nullptr, body);
+    }
+
+    void http_request::reply_ref(int code, std::string_view body, std::shared_ptr<const void> owner) {
+        auto* r = unstarted();
+        add_reference(evhttp_request_get_output_buffer(r), body, std::move(owner));
+        req = nullptr;
+        evhttp_send_reply(r, code, nullptr, nullptr);
+    }
+
+    void http_request::error(int code) {
+        auto* r = unstarted();
+        req = nullptr;
+        evhttp_send_error(r, code, nullptr);
+    }
+
+    void http_request::start(int code) {
+        auto* r = unstarted();
+        evhttp_send_reply_start(r, code, nullptr);
+        streaming = true;
+    }
+
+    void http_request::chunk(std::string_view data) {
+        auto* r = started();
+        // the output buffer is unused once the headers are out, so it serves as the chunk's staging
+        auto* scratch = evhttp_request_get_output_buffer(r);
+        evbuffer_add(scratch, data.data(), data.size());
+        evhttp_send_reply_chunk(r, scratch);
+        // left behind when the client has gone
+        evbuffer_drain(scratch, evbuffer_get_length(scratch));
+    }
+
+    void http_request::chunk(evbuffer* data) {
+        auto* r = started();
+        evhttp_send_reply_chunk(r, data);
+    }
+
+    void http_request::chunk_ref(std::string_view data, std::shared_ptr<const void> owner) {
+        auto* r = started();
+        auto* scratch = evhttp_request_get_output_buffer(r);
+        add_reference(scratch, data, std::move(owner));
+        evhttp_send_reply_chunk(r, scratch);
+        evbuffer_drain(scratch, evbuffer_get_length(scratch));
+    }
+
+    void http_request::end() {
+        auto* r = started();
+        req = nullptr;
+        streaming = false;
+        evhttp_send_reply_end(r);
+    }
+
+    namespace detail {
+        uint16_t http_listen(event_base* base, evhttp* http, const http_options& opts) {
+            evhttp_set_max_headers_size(http, static_cast<ev_ssize_t>(opts.max_headers_size));
+            evhttp_set_max_body_size(http, static_cast<ev_ssize_t>(opts.max_body_size));
+            evhttp_set_timeout(http, static_cast<int>(opts.timeout.count()));
+            // unrouted methods get 405 from the server's dispatch rather than 501 from evhttp
+            evhttp_set_allowed_methods(http, all_methods);
+
+            auto addrs = numeric_addresses(opts.address, opts.port);
+            if (addrs.empty()) {
+                throw std::invalid_argument{"HTTP listen address must be numeric: " + opts.address};
+            }
+            auto& a = addrs.front();
+
+            unsigned flags = LEV_OPT_CLOSE_ON_FREE | LEV_OPT_CLOSE_ON_EXEC | LEV_OPT_REUSEABLE;
+            if (opts.reuse_port) {
+                flags |= LEV_OPT_REUSEABLE_PORT;
+            }
+
+            auto* lev = evconnlistener_new_bind(
+                    base, nullptr, nullptr, flags, opts.backlog, reinterpret_cast<const sockaddr*>(&a.addr), a.len);
+            if (not lev) {
+                throw std::system_error{
+                        errno,
+                        std::system_category(),
+                        "Failed to listen on " + opts.address + ":" + std::to_string(opts.port)};
+            }
+
+            // inherited by accepted connections; otherwise Nagle holds back each response behind a pipelined
+            // one until the client's delayed ACK
+            int one{1};
+            ::setsockopt(evconnlistener_get_fd(lev), IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            // the server owns the listener from here on
+            if (not evhttp_bind_listener(http, lev)) {
+                evconnlistener_free(lev);
+                throw std::runtime_error{"Failed to bind http listener"};
+            }
+
+            sockaddr_storage bound{};
+            socklen_t len = sizeof(bound);
+            if (::getsockname(evconnlistener_get_fd(lev), reinterpret_cast<sockaddr*>(&bound), &len) != 0) {
+                throw std::system_error{errno, std::system_category(), "getsockname"};
+            }
+
+            if (bound.ss_family == AF_INET6) {
+                return ntohs(reinterpret_cast<const sockaddr_in6*>(&bound)->sin6_port);
+            }
+            return ntohs(reinterpret_cast<const sockaddr_in*>(&bound)->sin_port);
+        }
+    }  // namespace detail
+}  // namespace un::event
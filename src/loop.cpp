@@ -2,6 +2,19 @@
 
 #include <unlog/config.hpp>
 
+#include <cerrno>
+#include <system_error>
+
+#include <pthread.h>
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #ifdef UNEVENTFUL_SSL_ENABLED
 extern "C" {
 #include <openssl/err.h>
@@ -58,6 +71,89 @@ namespace un::event {
 
             throw std::runtime_error{"Failed to create edge-triggered or standard I/O event base!"};
         }
+
+        static void throw_errno(int err, const char* what) {
+            throw std::system_error{err, std::system_category(), what};
+        }
+
+#ifdef __linux__
+        static int to_native_policy(sched_policy p) {
+            switch (p) {
+                case sched_policy::batch:
+                    return SCHED_BATCH;
+                case sched_policy::idle:
+                    return SCHED_IDLE;
+                case sched_policy::fifo:
+                    return SCHED_FIFO;
+                case sched_policy::rr:
+                    return SCHED_RR;
+                default:
+                    return SCHED_OTHER;
+            }
+        }
+
+        void apply_thread_options(const thread_options& opts) {
+            auto self = ::pthread_self();
+
+            if (not opts.name.empty()) {
+                // the kernel limit is 16 bytes including the terminator
+                auto name = opts.name.substr(0, 15);
+                if (auto rv = ::pthread_setname_np(self, name.c_str()); rv != 0) {
+                    throw_errno(rv, "pthread_setname_np");
+                }
+            }
+
+            if (not opts.cpu_affinity.empty()) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (auto cpu : opts.cpu_affinity) {
+                    if (cpu < 0 or cpu >= CPU_SETSIZE) {
+                        throw_errno(EINVAL, "cpu_affinity");
+                    }
+                    CPU_SET(cpu, &set);
+                }
+                if (auto rv = ::pthread_setaffinity_np(self, sizeof(set), &set); rv != 0) {
+                    throw_errno(rv, "pthread_setaffinity_np");
+                }
+            }
+
+            if (opts.policy != sched_policy::inherit) {
+                auto policy = to_native_policy(opts.policy);
+                sched_param param{};
+                param.sched_priority = (policy == SCHED_FIFO or policy == SCHED_RR) ? opts.priority : 0;
+                if (auto rv = ::pthread_setschedparam(self, policy, &param); rv != 0) {
+                    throw_errno(rv, "pthread_setschedparam");
+                }
+            }
+
+            // on linux niceness is a per-thread attribute when addressed by tid
+            if (opts.nice) {
+                if (::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), *opts.nice) != 0) {
+                    throw_errno(errno, "setpriority");
+                }
+            }
+
+            // prefer (rather than bind) so that allocation falls back to other nodes instead of failing
+            if (opts.numa_node) {
+                constexpr auto bits = sizeof(unsigned long) * 8;
+                auto node = *opts.numa_node;
+                if (node < 0 or node >= static_cast<int>(bits)) {
+                    throw_errno(EINVAL, "numa_node");
+                }
+                unsigned long mask = 1UL << node;
+                if (::syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask, bits) != 0) {
+                    throw_errno(errno, "set_mempolicy");
+                }
+            }
+        }
+#else
+        void apply_thread_options(const thread_options& opts) {
+            if (not opts.name.empty() or not opts.cpu_affinity.empty() or opts.policy != sched_policy::inherit or
+                opts.nice or opts.numa_node) {
+                throw_errno(ENOTSUP, "thread_options");
+            }
+        }
+#endif
     }  // namespace detail
 
 }  // namespace un::event
@@ -0,0 +1,95 @@
+#include "uneventful/pool.hpp"
+
+#include <new>
+
+namespace un::event {
+
+    object_pool::~object_pool() {
+        pool_chunk_allocator alloc{};
+        for (auto* c : chunks) {
+            alloc.deallocate(c, chunk_size);
+        }
+    }
+
+    size_t object_pool::reserved() const {
+        std::lock_guard lock{mutex};
+        return chunks.size() * chunk_size;
+    }
+
+    object_pool::node* object_pool::carve(size_t cls) {
+        auto slot = (cls + 1) * granularity;
+
+        if (static_cast<size_t>(bump_end - bump) < slot) {
+            pool_chunk_allocator alloc{};
+            bump = alloc.allocate(chunk_size);
+            bump_end = bump + chunk_size;
+            chunks.push_back(bump);
+        }
+
+        auto n = std::min(run_size, static_cast<size_t>(bump_end - bump)) / slot;
+        auto* first = reinterpret_cast<node*>(bump);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto* cur = reinterpret_cast<node*>(bump + i * slot);
+            cur->next = i + 1 < n ? reinterpret_cast<node*>(bump + (i + 1) * slot) : nullptr;
+        }
+        bump += n * slot;
+
+        return first;
+    }
+
+    void* object_pool::allocate(size_t size, size_t align, bool on_owner) {
+        if (not pooled(size, align)) {
+            return ::operator new(size, std::align_val_t{align});
+        }
+
+        auto cls = class_of(size);
+        auto& c = classes[cls];
+
+        if (on_owner) {
+            if (not c.local) {
+                c.local = c.remote.exchange(nullptr, std::memory_order_acquire);
+            }
+            if (not c.local) {
+                std::lock_guard lock{mutex};
+                c.local = carve(cls);
+            }
+
+            auto* n = c.local;
+            c.local = n->next;
+            return n;
+        }
+
+        std::lock_guard lock{mutex};
+        if (not c.shared) {
+            c.shared = c.remote.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (not c.shared) {
+            c.shared = carve(cls);
+        }
+
+        auto* n = c.shared;
+        c.shared = n->next;
+        return n;
+    }
+
+    void object_pool::deallocate(void* p, size_t size, size_t align, bool on_owner) noexcept {
+        if (not pooled(size, align)) {
+            ::operator delete(p, std::align_val_t{align});
+            return;
+        }
+
+        auto& c = classes[class_of(size)];
+        auto* n = static_cast<node*>(p);
+
+        if (on_owner) {
+            n->next = c.local;
+            c.local = n;
+            return;
+        }
+
+        n->next = c.remote.load(std::memory_order_relaxed);
+        while (not c.remote.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+}  // namespace un::event
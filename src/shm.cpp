@@ -0,0 +1,289 @@
+#include "uneventful/shm.hpp"
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+
+namespace un::event {
+
+    namespace {
+        constexpr uint64_t shm_magic{0x756e657673686d31};  // "unevshm1"
+        // length of the record that sends the reader back to the start of the ring
+        constexpr uint32_t wrap_marker{UINT32_MAX};
+        constexpr int required_seals{F_SEAL_SHRINK | F_SEAL_GROW};
+
+        constexpr uint64_t record_size(size_t payload) { return (payload + 4 + 7) & ~uint64_t{7}; }
+
+        [[noreturn]] void fail(const char* what) { throw std::system_error{errno, std::system_category(), what}; }
+
+        [[noreturn]] void corrupt() { throw std::runtime_error{"Corrupt shared memory channel"}; }
+    }  // namespace
+
+    shm_channel::shm_channel(int _memfd, int _efd) : memfd{_memfd}, efd{_efd} {
+        struct stat st{};
+        if (::fstat(memfd, &st) != 0) {
+            auto err = errno;
+            close();
+            throw std::system_error{err, std::system_category(), "fstat"};
+        }
+
+        map_size = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        if (p == MAP_FAILED) {
+            auto err = errno;
+            map_size = 0;
+            close();
+            throw std::system_error{err, std::system_category(), "mmap"};
+        }
+
+        hdr = static_cast<detail::shm_header*>(p);
+        data = static_cast<std::byte*>(p) + detail::shm_data_offset;
+    }
+
+    shm_channel& shm_channel::operator=(shm_channel&& c) noexcept {
+        if (this != &c) {
+            close();
+            memfd = std::exchange(c.memfd, -1);
+            efd = std::exchange(c.efd, -1);
+            hdr = std::exchange(c.hdr, nullptr);
+            data = std::exchange(c.data, nullptr);
+            map_size = std::exchange(c.map_size, 0);
+            ring_size = std::exchange(c.ring_size, 0);
+            staged = c.staged;
+            reserved = std::exchange(c.reserved, std::nullopt);
+            notifies = c.notifies;
+        }
+        return *this;
+    }
+
+    void shm_channel::close() noexcept {
+        if (hdr) {
+            ::munmap(hdr, map_size);
+            hdr = nullptr;
+            data = nullptr;
+            ring_size = 0;
+        }
+        if (memfd >= 0) {
+            ::close(std::exchange(memfd, -1));
+        }
+        if (efd >= 0) {
+            ::close(std::exchange(efd, -1));
+        }
+    }
+
+    shm_channel shm_channel::create(size_t capacity) {
+        auto cap = std::bit_ceil(std::max<size_t>(capacity, 4096));
+
+        int mfd = ::memfd_create("uneventful-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (mfd < 0) {
+            fail("memfd_create");
+        }
+        // sealed at its size, so that neither side can truncate the ring under the other's mapping
+        if (::ftruncate(mfd, static_cast<off_t>(detail::shm_data_offset + cap)) != 0 or
+            ::fcntl(mfd, F_ADD_SEALS, required_seals | F_SEAL_SEAL) != 0) {
+            auto err = errno;
+            ::close(mfd);
+            throw std::system_error{err, std::system_category(), "Failed to size shared memory channel"};
+        }
+
+        int e = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (e < 0) {
+            auto err = errno;
+            ::close(mfd);
+            throw std::system_error{err, std::system_category(), "eventfd"};
+        }
+
+        shm_channel ch{mfd, e};
+        // the reader starts out asleep, so the first publish wakes it
+        new (ch.hdr) detail::shm_header{shm_magic, cap, {0}, {0}, {1}};
+        ch.ring_size = cap;
+        return ch;
+    }
+
+    shm_channel shm_channel::receive(int sock) {
+        char byte;
+        iovec iov{&byte, 1};
+        alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))]{};
+
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t n;
+        while ((n = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC)) < 0 and errno == EINTR) {}
+        if (n < 0) {
+            fail("recvmsg");
+        }
+
+        auto* c = CMSG_FIRSTHDR(&msg);
+        if (not c or c->cmsg_level != SOL_SOCKET or c->cmsg_type != SCM_RIGHTS or
+            c->cmsg_len != CMSG_LEN(2 * sizeof(int))) {
+            throw std::runtime_error{"No shared memory channel received"};
+        }
+        int fds[2];
+        std::memcpy(fds, CMSG_DATA(c), sizeof(fds));
+
+        // a peer that could still resize the memfd could fault this process through the mapping
+        if (int seals = ::fcntl(fds[0], F_GET_SEALS); seals < 0 or (seals & required_seals) != required_seals) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            throw std::runtime_error{"Shared memory channel is not sealed"};
+        }
+
+        shm_channel ch{fds[0], fds[1]};
+        auto cap = ch.hdr->capacity;
+        if (ch.hdr->magic != shm_magic or not std::has_single_bit(cap) or
+            ch.map_size != detail::shm_data_offset + cap) {
+            throw std::runtime_error{"Invalid shared memory channel"};
+        }
+        ch.ring_size = cap;
+        ch.staged = ch.hdr->head.load(std::memory_order_acquire);
+        return ch;
+    }
+
+    void shm_channel::send_to(int sock) const {
+        char byte{0};
+        iovec iov{&byte, 1};
+        alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))]{};
+
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        auto* c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(2 * sizeof(int));
+        int fds[2]{memfd, efd};
+        std::memcpy(CMSG_DATA(c), fds, sizeof(fds));
+
+        ssize_t n;
+        while ((n = ::sendmsg(sock, &msg, MSG_NOSIGNAL)) < 0 and errno == EINTR) {}
+        if (n < 0) {
+            fail("sendmsg");
+        }
+    }
+
+    std::span<std::byte> shm_channel::reserve(size_t size) {
+        if (size > max_message()) {
+            throw std::length_error{"Message does not fit the shared memory channel"};
+        }
+
+        const auto cap = ring_size;
+        const auto need = record_size(size);
+        const auto pos = staged & (cap - 1);
+        // records never straddle the end; one that doesn't fit there starts over at the front
+        const uint64_t skip = cap - pos < need ? cap - pos : 0;
+
+        if (staged + skip + need - hdr->tail.load(std::memory_order_acquire) > cap) {
+            return {};
+        }
+
+        if (skip) {
+            std::memcpy(data + pos, &wrap_marker, sizeof(wrap_marker));
+            staged += skip;
+        }
+
+        reserved = size;
+        return {data + (staged & (cap - 1)) + 4, size};
+    }
+
+    void shm_channel::commit(size_t size) {
+        if (not reserved) {
+            throw std::logic_error{"Nothing reserved in the shared memory channel"};
+        }
+        size = std::min(size, *std::exchange(reserved, std::nullopt));
+
+        uint32_t len = static_cast<uint32_t>(size);
+        std::memcpy(data + (staged & (ring_size - 1)), &len, sizeof(len));
+        staged += record_size(size);
+    }
+
+    bool shm_channel::try_write(std::string_view msg) {
+        auto buf = reserve(msg.size());
+        if (buf.data() == nullptr) {
+            return false;
+        }
+        std::memcpy(buf.data(), msg.data(), msg.size());
+        commit(msg.size());
+        return true;
+    }
+
+    void shm_channel::publish() {
+        if (staged == hdr->head.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // sequentially consistent with `arm`: either the reader sees the new head, or this sees it waiting
+        hdr->head.store(staged, std::memory_order_seq_cst);
+        if (hdr->waiting.load(std::memory_order_seq_cst) and hdr->waiting.exchange(0, std::memory_order_seq_cst)) {
+            uint64_t one{1};
+            while (::write(efd, &one, sizeof(one)) < 0 and errno == EINTR) {}
+            ++notifies;
+        }
+    }
+
+    size_t shm_channel::read(const std::function<void(std::string_view)>& f, size_t max) {
+        const auto cap = ring_size;
+        auto t = hdr->tail.load(std::memory_order_relaxed);
+        const auto h = hdr->head.load(std::memory_order_acquire);
+
+        // the peer can write anything into the header and the ring, so every record is checked to
+        // lie within both the published span and the mapping before it is read
+        if (h - t > cap or ((t | h) & 7) != 0) {
+            corrupt();
+        }
+
+        size_t n{0};
+        while (t != h and n < max) {
+            const auto pos = t & (cap - 1);
+            uint32_t len;
+            std::memcpy(&len, data + pos, sizeof(len));
+
+            if (len == wrap_marker) {
+                if (cap - pos > h - t) {
+                    corrupt();
+                }
+                t += cap - pos;
+                continue;
+            }
+            if (len > max_message() or record_size(len) > h - t or record_size(len) > cap - pos) {
+                corrupt();
+            }
+
+            f({reinterpret_cast<const char*>(data + pos + 4), len});
+            t += record_size(len);
+            ++n;
+        }
+
+        hdr->tail.store(t, std::memory_order_release);
+        return n;
+    }
+
+    bool shm_channel::arm() {
+        hdr->waiting.store(1, std::memory_order_seq_cst);
+        if (hdr->head.load(std::memory_order_seq_cst) != hdr->tail.load(std::memory_order_relaxed)) {
+            hdr->waiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void shm_channel::drain_wakeups() const {
+        uint64_t count;
+        while (::read(efd, &count, sizeof(count)) < 0 and errno == EINTR) {}
+    }
+}  // namespace un::event
@@ -0,0 +1,172 @@
+#include "uneventful/signal.hpp"
+
+#include <pthread.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace un::event {
+
+    namespace {
+        struct signal_registry {
+            std::mutex mutex;
+            // blocked by every thread uneventful starts
+            sigset_t blocked{};
+            // loop currently reading each signal
+            std::array<const void*, NSIG> owner{};
+
+            signal_registry() { sigemptyset(&blocked); }
+        };
+
+        signal_registry& registry() {
+            static signal_registry r;
+            return r;
+        }
+
+        void check_signo(int signo) {
+            if (signo <= 0 or signo >= NSIG or signo == SIGKILL or signo == SIGSTOP) {
+                throw std::invalid_argument{"Signal " + std::to_string(signo) + " cannot be watched"};
+            }
+        }
+    }  // namespace
+
+    void block_signals(std::initializer_list<int> signals) {
+        for (auto signo : signals) {
+            check_signo(signo);
+            detail::block_signal(signo);
+        }
+    }
+
+    namespace detail {
+        void block_signal(int signo) {
+            sigset_t one;
+            sigemptyset(&one);
+            sigaddset(&one, signo);
+
+            {
+                auto& r = registry();
+                std::lock_guard lock{r.mutex};
+                sigaddset(&r.blocked, signo);
+            }
+
+            ::pthread_sigmask(SIG_BLOCK, &one, nullptr);
+        }
+
+        void block_watched_signals() {
+            auto& r = registry();
+            sigset_t set;
+            {
+                std::lock_guard lock{r.mutex};
+                set = r.blocked;
+            }
+            ::pthread_sigmask(SIG_BLOCK, &set, nullptr);
+        }
+
+        signal_fd::signal_fd(event_base* base, event_callback_fn cb, void* arg) {
+            sigemptyset(&mask);
+
+            fd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+            if (fd < 0) {
+                throw std::system_error{errno, std::system_category(), "signalfd"};
+            }
+
+            ev.reset(event_new(base, fd, EV_READ | EV_PERSIST, cb, arg));
+            if (not ev or event_add(ev.get(), nullptr) != 0) {
+                ::close(fd);
+                throw std::runtime_error{"Failed to create signal event"};
+            }
+        }
+
+        signal_fd::~signal_fd() {
+            ev.reset();
+            ::close(fd);
+
+            auto& r = registry();
+            std::lock_guard lock{r.mutex};
+            for (auto& o : r.owner) {
+                if (o == this) {
+                    o = nullptr;
+                }
+            }
+        }
+
+        void signal_fd::add(int signo) {
+            check_signo(signo);
+
+            if (refs[signo] > 0) {
+                ++refs[signo];
+                return;
+            }
+
+            {
+                auto& r = registry();
+                std::lock_guard lock{r.mutex};
+                if (r.owner[signo] and r.owner[signo] != this) {
+                    throw std::logic_error{"Signal " + std::to_string(signo) + " is already watched by another loop"};
+                }
+                r.owner[signo] = this;
+            }
+
+            // the loop thread reads the signal, so it must never have it delivered the usual way
+            block_signal(signo);
+
+            sigaddset(&mask, signo);
+            if (::signalfd(fd, &mask, 0) < 0) {
+                auto err = errno;
+                sigdelset(&mask, signo);
+                release(signo);
+                throw std::system_error{err, std::system_category(), "signalfd"};
+            }
+            refs[signo] = 1;
+        }
+
+        void signal_fd::remove(int signo) {
+            if (refs[signo] == 0 or --refs[signo] > 0) {
+                return;
+            }
+
+            // stays blocked: unblocking could deliver a pending signal with its default action
+            sigdelset(&mask, signo);
+            ::signalfd(fd, &mask, 0);
+            release(signo);
+        }
+
+        void signal_fd::release(int signo) {
+            auto& r = registry();
+            std::lock_guard lock{r.mutex};
+            if (r.owner[signo] == this) {
+                r.owner[signo] = nullptr;
+            }
+        }
+
+        void signal_fd::read(std::array<uint32_t, NSIG>& counts) {
+            signalfd_siginfo infos[32];
+
+            for (;;) {
+                auto n = ::read(fd, infos, sizeof(infos));
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    // EAGAIN: everything queued has been read
+                    return;
+                }
+
+                for (size_t i = 0; i < static_cast<size_t>(n) / sizeof(signalfd_siginfo); ++i) {
+                    if (auto signo = infos[i].ssi_signo; signo < NSIG) {
+                        ++counts[signo];
+                    }
+                }
+
+                if (static_cast<size_t>(n) < sizeof(infos)) {
+                    return;
+                }
+            }
+        }
+    }  // namespace detail
+}  // namespace un::event
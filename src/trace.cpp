@@ -0,0 +1,174 @@
+#include "uneventful/trace.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace un::event {
+
+    namespace detail {
+        uint32_t thread_tag() noexcept {
+            thread_local const uint32_t tag = [] {
+#ifdef __linux__
+                return static_cast<uint32_t>(::syscall(SYS_gettid));
+#else
+                return static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+#endif
+            }();
+            return tag;
+        }
+
+        static void append_escaped(std::string& out, std::string_view s) {
+            for (auto c : s) {
+                switch (c) {
+                    case '"':
+                        out += "\\\"";
+                        break;
+                    case '\\':
+                        out += "\\\\";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char buf[8];
+                            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                            out += buf;
+                        }
+                        else {
+                            out += c;
+                        }
+                }
+            }
+        }
+
+        static const char* trace_kind_name(trace_kind k) {
+            switch (k) {
+                case trace_kind::wakeup:
+                    return "wakeup";
+                case trace_kind::drain:
+                    return "drain";
+                case trace_kind::job:
+                    return "job";
+                case trace_kind::timer:
+                    return "timer";
+                case trace_kind::io:
+                    return "io";
+            }
+            return "unknown";
+        }
+    }  // namespace detail
+
+    std::vector<trace_record> trace_buffer::snapshot() const {
+        std::vector<trace_record> out;
+
+        auto end = head.load(std::memory_order_acquire);
+        auto begin = end > capacity() ? end - capacity() : 0;
+        out.reserve(end - begin);
+
+        for (auto i = begin; i < end; ++i) {
+            const auto& s = slots[i & mask];
+
+            auto seq = s.seq.load(std::memory_order_acquire);
+            if (seq != 2 * i + 2) {
+                // still being written, or already overwritten by a newer record
+                continue;
+            }
+
+            trace_record r{
+                    .ts_ns = s.ts_ns.load(std::memory_order_relaxed),
+                    .dur_ns = s.dur_ns.load(std::memory_order_relaxed),
+                    .arg = s.arg.load(std::memory_order_relaxed),
+                    .file = s.file.load(std::memory_order_relaxed)};
+            auto packed = s.line_tid_kind.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) != seq) {
+                continue;
+            }
+
+            r.line = static_cast<uint32_t>(packed >> 32);
+            r.tid = static_cast<uint32_t>((packed >> 8) & 0x00ff'ffff);
+            r.kind = static_cast<trace_kind>(packed & 0xff);
+            out.push_back(r);
+        }
+
+        std::ranges::stable_sort(out, {}, &trace_record::ts_ns);
+        return out;
+    }
+
+    std::string trace_buffer::to_chrome_json() const {
+        auto records = snapshot();
+        auto pid = static_cast<long>(::getpid());
+
+        std::string out;
+        out.reserve(64 + records.size() * 128);
+        out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        char buf[192];
+        bool first = true;
+        for (const auto& r : records) {
+            if (not first) {
+                out += ',';
+            }
+            first = false;
+
+            auto ts_us = static_cast<double>(r.ts_ns) / 1e3;
+            auto name = detail::trace_kind_name(r.kind);
+            const char* sep = "";
+
+            if (r.kind == trace_kind::wakeup) {
+                std::snprintf(
+                        buf,
+                        sizeof(buf),
+                        "{\"name\":\"%s\",\"cat\":\"unevent\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%ld,"
+                        "\"tid\":%u,\"args\":{",
+                        name,
+                        ts_us,
+                        pid,
+                        r.tid);
+            }
+            else {
+                std::snprintf(
+                        buf,
+                        sizeof(buf),
+                        "{\"name\":\"%s\",\"cat\":\"unevent\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,"
+                        "\"tid\":%u,\"args\":{",
+                        name,
+                        ts_us,
+                        static_cast<double>(r.dur_ns) / 1e3,
+                        pid,
+                        r.tid);
+            }
+            out += buf;
+
+            if (r.kind == trace_kind::drain) {
+                out += "\"jobs\":" + std::to_string(r.arg);
+                sep = ",";
+            }
+
+            if (r.file and r.kind == trace_kind::io) {
+                out += sep;
+                out += "\"source\":\"";
+                detail::append_escaped(out, r.file);
+                out += '"';
+            }
+            else if (r.file) {
+                out += sep;
+                out += "\"site\":\"";
+                detail::append_escaped(out, r.file);
+                out += ':' + std::to_string(r.line) + '"';
+            }
+
+            out += "}}";
+        }
+
+        out += "]}";
+        return out;
+    }
+}  // namespace un::event
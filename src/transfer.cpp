@@ -0,0 +1,218 @@
+#include "uneventful/transfer.hpp"
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+
+namespace un::event {
+
+    namespace {
+        // what a single splice into the private pipe may carry
+        constexpr size_t pipe_capacity{1U << 20};
+    }  // namespace
+
+    void transfer_registry::cancel_all() {
+        for (;;) {
+            detail::tracked_op* op;
+            {
+                std::lock_guard lock{mutex};
+                if (not head) {
+                    return;
+                }
+                op = head;
+                op->unlink(head);
+            }
+            op->stop(op);
+        }
+    }
+
+    file_transfer::file_transfer(
+            const std::atomic<trace_buffer*>& _trace,
+            int out_fd,
+            int in_fd,
+            off_t off,
+            size_t count,
+            completion d,
+            const transfer_options& opts) :
+            trace{_trace},
+            out{out_fd},
+            in{in_fd},
+            offset{off},
+            remaining{count},
+            slice{std::max<size_t>(opts.slice, 1)},
+            use_splice{opts.splice},
+            done{std::move(d)} {
+        stop = &file_transfer::abandon;
+    }
+
+    file_transfer::~file_transfer() {
+        if (pipe_r >= 0) {
+            ::close(pipe_r);
+            ::close(pipe_w);
+        }
+    }
+
+    std::shared_ptr<file_transfer> file_transfer::start(
+            event_base* base,
+            transfer_registry& registry,
+            const std::atomic<trace_buffer*>& trace,
+            int out_fd,
+            int in_fd,
+            off_t offset,
+            size_t count,
+            completion done,
+            const transfer_options& opts) {
+        auto t = std::shared_ptr<file_transfer>{
+                new file_transfer{trace, out_fd, in_fd, offset, count, std::move(done), opts}};
+
+        short what = EV_WRITE | EV_PERSIST;
+        if (event_base_get_features(base) & EV_FEATURE_ET) {
+            what |= EV_ET;
+        }
+
+        t->ev.reset(event_new(base, out_fd, what, &file_transfer::on_writable, t.get()));
+        if (not t->ev or event_add(t->ev.get(), nullptr) != 0) {
+            throw std::runtime_error{"Failed to create file transfer event"};
+        }
+
+        t->self = t;
+        {
+            std::lock_guard lock{registry.mutex};
+            t->link(registry.head);
+        }
+        t->registry = &registry;
+
+        // the socket may well be writable already, and an edge that happened before we were
+        // watching is never reported
+        event_active(t->ev.get(), EV_WRITE, 0);
+
+        return t;
+    }
+
+    void file_transfer::cancel() {
+        if (self) {
+            finish(std::make_error_code(std::errc::operation_canceled));
+        }
+    }
+
+    void file_transfer::on_writable(evutil_socket_t, short, void* arg) {
+        auto* t = static_cast<file_transfer*>(arg);
+        if (t->self) {
+            detail::io_trace_scope traced{t->trace, "transfer"};
+            t->pump();
+        }
+    }
+
+    void file_transfer::abandon(detail::tracked_op* op) noexcept {
+        auto* t = static_cast<file_transfer*>(op);
+        // a handle the caller still holds must not free the event once the base is gone
+        auto keep = t->self;
+        t->cancel();
+        t->ev.reset();
+    }
+
+    void file_transfer::pump() {
+        size_t budget = slice;
+
+        while (remaining > 0) {
+            if (budget == 0) {
+                // more to go, but let the loop's other events in first
+                event_active(ev.get(), EV_WRITE, 0);
+                return;
+            }
+
+            auto want = std::min(remaining, budget);
+            auto n = use_splice ? move_splice(want) : move_sendfile(want);
+
+            if (n > 0) {
+                bytes_sent += static_cast<size_t>(n);
+                remaining -= static_cast<size_t>(n);
+                budget -= std::min(budget, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == 0) {
+                break;
+            }
+
+            switch (errno) {
+                case EINTR:
+                    continue;
+                case EAGAIN:
+                    // socket full; resume on the next writable edge
+                    return;
+                case EINVAL:
+                case ENOSYS:
+                    // the source filesystem does not support sendfile
+                    if (not use_splice and bytes_sent == 0 and open_pipe()) {
+                        use_splice = true;
+                        continue;
+                    }
+                    [[fallthrough]];
+                default:
+                    finish(std::error_code{errno, std::system_category()});
+                    return;
+            }
+        }
+
+        finish({});
+    }
+
+    ssize_t file_transfer::move_sendfile(size_t want) {
+        // sendfile moves at most 0x7ffff000 bytes per call
+        return ::sendfile(out, in, &offset, std::min<size_t>(want, 0x7ffff000));
+    }
+
+    ssize_t file_transfer::move_splice(size_t want) {
+        if (pipe_r < 0 and not open_pipe()) {
+            return -1;
+        }
+
+        if (piped == 0) {
+            auto n = ::splice(
+                    in, &offset, pipe_w, nullptr, std::min(want, pipe_capacity), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n <= 0) {
+                return n;
+            }
+            piped = static_cast<size_t>(n);
+        }
+
+        auto n = ::splice(pipe_r, nullptr, out, nullptr, std::min(want, piped), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0) {
+            piped -= static_cast<size_t>(n);
+        }
+        return n;
+    }
+
+    bool file_transfer::open_pipe() {
+        int fds[2];
+        if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+            return false;
+        }
+        pipe_r = fds[0];
+        pipe_w = fds[1];
+
+        // best effort: a larger pipe means fewer splice round trips
+        ::fcntl(pipe_w, F_SETPIPE_SZ, static_cast<int>(pipe_capacity));
+        return true;
+    }
+
+    void file_transfer::finish(std::error_code ec) {
+        // may drop the last reference; stay alive until done has been called
+        auto keep = std::move(self);
+
+        if (auto* r = std::exchange(registry, nullptr)) {
+            std::lock_guard lock{r->mutex};
+            unlink(r->head);
+        }
+        event_del(ev.get());
+
+        if (done) {
+            std::exchange(done, nullptr)(ec, bytes_sent);
+        }
+    }
+}  // namespace un::event
@@ -396,6 +396,10 @@ namespace un::event::test {
             test_helper::queue_jobs(
                     *loop,
                     [owned, &first_done, &first_done_set]() mutable {
+                        // the test's own handle may not be gone yet when the loop thread gets here first
+                        while (owned->use_count() > 1) {
+                            std::this_thread::yield();
+                        }
                         owned->reset();
                         if (!first_done_set.exchange(true))
                             first_done.set_value();
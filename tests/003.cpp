@@ -0,0 +1,128 @@
+#include "utils.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    TEST_CASE("event_loop applies thread name", "[event_loop][options]") {
+        loop_options opts;
+        opts.thread.name = "unevent-test-loop-name";
+
+        auto loop = test_loop::make(opts);
+
+        auto name = loop->call_get([] {
+            std::array<char, 16> buf{};
+            pthread_getname_np(pthread_self(), buf.data(), buf.size());
+            return std::string{buf.data()};
+        });
+
+        REQUIRE(name == opts.thread.name.substr(0, 15));
+    }
+
+    TEST_CASE("event_loop applies cpu affinity", "[event_loop][options]") {
+        cpu_set_t current;
+        CPU_ZERO(&current);
+        REQUIRE(sched_getaffinity(0, sizeof(current), &current) == 0);
+
+        int target = -1;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &current)) {
+                target = cpu;
+                break;
+            }
+        }
+        REQUIRE(target >= 0);
+
+        loop_options opts;
+        opts.thread.cpu_affinity = {target};
+
+        auto loop = test_loop::make(opts);
+
+        auto cpus = loop->call_get([] {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+
+            std::vector<int> out;
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set))
+                    out.push_back(cpu);
+            }
+            return out;
+        });
+
+        REQUIRE(cpus == std::vector<int>{target});
+    }
+
+    TEST_CASE("event_loop applies non-realtime policy", "[event_loop][options]") {
+        loop_options opts;
+        opts.thread.policy = sched_policy::batch;
+
+        auto loop = test_loop::make(opts);
+
+        auto policy = loop->call_get([] {
+            int p{};
+            sched_param param{};
+            pthread_getschedparam(pthread_self(), &p, &param);
+            return p;
+        });
+
+        REQUIRE(policy == SCHED_BATCH);
+    }
+
+    TEST_CASE("event_loop construction fails on invalid thread options", "[event_loop][options]") {
+        loop_options opts;
+        opts.thread.cpu_affinity = {-1};
+
+        REQUIRE_THROWS_AS(test_loop::make(opts), std::system_error);
+    }
+
+    TEST_CASE("event_loop busy-poll mode runs cross-thread jobs", "[event_loop][options][spin]") {
+        using namespace std::chrono_literals;
+
+        loop_options opts;
+        opts.spin_budget = 500us;
+
+        auto loop = test_loop::make(opts);
+
+        for (int i = 0; i < 3; ++i) {
+            // first post lands while spinning, the later ones after the loop has parked
+            std::promise<bool> p;
+            auto fut = p.get_future();
+            loop->call_soon([&] { p.set_value(loop->in_event_loop()); });
+
+            REQUIRE(fut.wait_for(200ms) == std::future_status::ready);
+            REQUIRE(fut.get());
+
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+
+    TEST_CASE("event_loop busy-poll mode fires timers", "[event_loop][options][spin]") {
+        using namespace std::chrono_literals;
+
+        loop_options opts;
+        opts.spin_budget = 200us;
+
+        auto loop = test_loop::make(opts);
+        std::atomic<int> count{0};
+        std::promise<void> done;
+        auto done_fut = done.get_future();
+
+        loop->call_later(5ms, [&] { count.fetch_add(1); });
+        loop->call_later(20ms, [&] { done.set_value(); });
+
+        REQUIRE(done_fut.wait_for(500ms) == std::future_status::ready);
+        REQUIRE(count.load() == 1);
+        REQUIRE(loop->call_get([] { return 3; }) == 3);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,86 @@
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace un::event::test {
+    TEST_CASE("log_histogram buckets bound their values", "[metrics][histogram]") {
+        using hist = log_histogram<>;
+
+        for (uint64_t v : {0ULL, 1ULL, 7ULL, 8ULL, 9ULL, 15ULL, 16ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+            auto idx = hist::index_of(v);
+            REQUIRE(hist::upper_bound_of(idx) >= v);
+            if (idx > 0)
+                REQUIRE(hist::upper_bound_of(idx - 1) < v);
+        }
+    }
+
+    TEST_CASE("log_histogram snapshot percentiles", "[metrics][histogram]") {
+        log_histogram<> h;
+
+        for (uint64_t v = 1; v <= 1000; ++v)
+            h.record(v);
+
+        auto s = h.snapshot();
+        REQUIRE(s.count == 1000);
+        REQUIRE(s.max == 1000);
+        REQUIRE(s.sum == 500500);
+
+        // 3 sub-bucket bits bound the relative error at 12.5%
+        auto p50 = s.percentile(0.5);
+        REQUIRE(p50 >= 500);
+        REQUIRE(p50 <= 563);
+        REQUIRE(s.percentile(1.0) == 1000);
+    }
+
+#if UNEVENT_METRICS
+    TEST_CASE("event_loop records job metrics", "[event_loop][metrics]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+
+        for (int i = 0; i < 10; ++i)
+            loop->call_soon([] {});
+        loop->call_soon([] { throw std::runtime_error("boom"); });
+        loop->call_get([] { std::this_thread::sleep_for(2ms); });
+
+        // the call_get above returns before its job is counted as run; a snapshot taken by a later
+        // job sees every earlier one settled, and itself only as posted and dequeued
+        auto m = loop->call_get([&] { return loop->metrics(); });
+        REQUIRE(m.jobs_posted == 13);
+        REQUIRE(m.jobs_run == 12);
+        REQUIRE(m.job_exceptions == 1);
+        REQUIRE(m.queue_depth == 1);
+        REQUIRE(m.drains >= 2);
+        REQUIRE(m.job_duration_ns.count == 12);
+        REQUIRE(m.job_duration_ns.max >= 2'000'000);
+        REQUIRE(m.queue_delay_ns.count == 13);
+        REQUIRE(m.drain_size.sum == 13);
+    }
+
+    TEST_CASE("event_loop records timer lag", "[event_loop][metrics]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        std::promise<void> p;
+        auto fut = p.get_future();
+        std::atomic<int> count{0};
+
+        auto watcher = loop->call_every(5ms, [&] {
+            if (count.fetch_add(1) + 1 == 3)
+                p.set_value();
+        });
+
+        REQUIRE(fut.wait_for(500ms) == std::future_status::ready);
+        loop->call_get([&] { watcher->stop(); });
+
+        auto m = loop->metrics();
+        REQUIRE(m.timer_fires >= 3);
+        REQUIRE(m.timer_lag_ns.count == m.timer_fires);
+        REQUIRE(m.timer_lag_ns.max < 100'000'000);
+    }
+#endif
+}  // namespace un::event::test
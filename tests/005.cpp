@@ -0,0 +1,103 @@
+#include "utils.hpp"
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <source_location>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    namespace {
+        struct report_sink {
+            std::mutex m;
+            std::vector<slow_callback_report> reports;
+
+            loop_options options(std::chrono::microseconds threshold) {
+                loop_options opts;
+                opts.slow_callback_threshold = threshold;
+                opts.on_slow_callback = [this](const slow_callback_report& r) {
+                    std::lock_guard lock{m};
+                    reports.push_back(r);
+                };
+                return opts;
+            }
+
+            std::vector<slow_callback_report> get() {
+                std::lock_guard lock{m};
+                return reports;
+            }
+        };
+    }  // namespace
+
+    TEST_CASE("event_loop watchdog reports slow jobs with their call site", "[event_loop][watchdog]") {
+        using namespace std::chrono_literals;
+
+        report_sink sink;
+        auto loop = test_loop::make(sink.options(2ms));
+
+        loop->call_get([] {});
+        REQUIRE(sink.get().empty());
+
+        auto line = std::source_location::current().line() + 1;
+        loop->call_soon([] { std::this_thread::sleep_for(10ms); });
+        loop->call_get([] {});
+
+        auto reports = sink.get();
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].kind == callback_kind::job);
+        REQUIRE(reports[0].duration >= 10ms);
+        REQUIRE(reports[0].site.line() == line);
+        REQUIRE(reports[0].parent.line() == 0);
+    }
+
+    TEST_CASE("event_loop watchdog records the posting job as parent", "[event_loop][watchdog]") {
+        using namespace std::chrono_literals;
+
+        report_sink sink;
+        auto loop = test_loop::make(sink.options(2ms));
+
+        std::promise<void> p;
+        auto fut = p.get_future();
+
+        auto outer_line = std::source_location::current().line() + 1;
+        loop->call_soon([&] {
+            loop->call_soon([&] {
+                std::this_thread::sleep_for(5ms);
+                p.set_value();
+            });
+        });
+
+        REQUIRE(fut.wait_for(200ms) == std::future_status::ready);
+        loop->call_get([] {});
+
+        auto reports = sink.get();
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].site.line() == outer_line + 1);
+        REQUIRE(reports[0].parent.line() == outer_line);
+    }
+
+    TEST_CASE("event_loop watchdog reports slow timers", "[event_loop][watchdog]") {
+        using namespace std::chrono_literals;
+
+        report_sink sink;
+        auto loop = test_loop::make(sink.options(2ms));
+
+        std::promise<void> p;
+        auto fut = p.get_future();
+
+        auto line = std::source_location::current().line() + 1;
+        loop->call_later(1ms, [&] {
+            std::this_thread::sleep_for(5ms);
+            p.set_value();
+        });
+
+        REQUIRE(fut.wait_for(200ms) == std::future_status::ready);
+        loop->call_get([] {});
+
+        auto reports = sink.get();
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].kind == callback_kind::timer);
+        REQUIRE(reports[0].site.line() == line);
+    }
+}  // namespace un::event::test
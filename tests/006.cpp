@@ -0,0 +1,94 @@
+#include "utils.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+
+namespace un::event::test {
+    TEST_CASE("trace_buffer keeps the most recent records", "[trace]") {
+        trace_buffer buf{4};
+        REQUIRE(buf.capacity() == 4);
+
+        for (uint64_t i = 1; i <= 10; ++i)
+            buf.emit(trace_kind::job, i, 1, i, "file.cpp", static_cast<uint32_t>(i));
+
+        auto records = buf.snapshot();
+        REQUIRE(records.size() == 4);
+        REQUIRE(records.front().ts_ns == 7);
+        REQUIRE(records.back().ts_ns == 10);
+        REQUIRE(records.back().line == 10);
+        REQUIRE(records.back().kind == trace_kind::job);
+        REQUIRE(records.back().tid == detail::thread_tag());
+    }
+
+    TEST_CASE("event_loop records nothing until tracing starts", "[event_loop][trace]") {
+        auto loop = test_loop::make();
+
+        loop->call_get([] {});
+        REQUIRE(loop->trace_json() == R"({"displayTimeUnit":"ns","traceEvents":[]})");
+
+        loop->start_tracing();
+        loop->stop_tracing();
+        loop->call_get([] {});
+
+        REQUIRE(loop->trace_json().find("\"name\":\"job\"") == std::string::npos);
+    }
+
+    TEST_CASE("event_loop traces wakeups, drains, jobs and timers", "[event_loop][trace]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        loop->start_tracing();
+
+        std::promise<void> p;
+        auto fut = p.get_future();
+
+        loop->call_soon([] {});
+        loop->call_later(1ms, [&] { p.set_value(); });
+
+        REQUIRE(fut.wait_for(200ms) == std::future_status::ready);
+        loop->call_get([] {});
+        loop->stop_tracing();
+
+        auto json = loop->trace_json();
+        REQUIRE(json.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[{)"));
+        REQUIRE(json.ends_with("}]}"));
+        REQUIRE(json.find("\"name\":\"wakeup\"") != std::string::npos);
+        REQUIRE(json.find("\"name\":\"drain\"") != std::string::npos);
+        REQUIRE(json.find("\"name\":\"job\"") != std::string::npos);
+        REQUIRE(json.find("\"name\":\"timer\"") != std::string::npos);
+        REQUIRE(json.find("006.cpp:") != std::string::npos);
+    }
+
+    TEST_CASE("event_loop traces I/O callbacks with their source", "[event_loop][trace][stream]") {
+        auto loop = test_loop::make();
+
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0);
+        auto s = loop->make_stream(fds[0]);
+
+        std::promise<void> p;
+        loop->call_get([&] {
+            s->on_data([&](test_loop::stream& st) {
+                st.read_all();
+                p.set_value();
+            });
+        });
+        loop->start_tracing();
+
+        REQUIRE(::write(fds[1], "ping", 4) == 4);
+        p.get_future().wait();
+        loop->call_get([] {});
+        loop->stop_tracing();
+
+        auto json = loop->trace_json();
+        REQUIRE(json.find(R"("name":"io")") != std::string::npos);
+        REQUIRE(json.find(R"("source":"stream")") != std::string::npos);
+
+        s.reset();
+        ::close(fds[1]);
+    }
+}  // namespace un::event::test
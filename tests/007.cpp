@@ -0,0 +1,162 @@
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    using clock = std::chrono::steady_clock;
+
+    namespace {
+        /** Where a fixed-rate ticker's grid lies: its k-th deadline is k intervals after its start,
+            which is somewhere between `before` and `after`, read on the loop thread either side of
+            creating the ticker.
+         */
+        struct tick_grid {
+            clock::time_point before{};
+            clock::time_point after{};
+            clock::duration interval;
+
+            // Whether a tick reporting `late` missed periods could have run at `t` for grid point `k`
+            bool late_by(clock::time_point t, int64_t k, uint64_t late) const {
+                auto n = k + static_cast<int64_t>(late);
+                return t >= before + interval * n and t < after + interval * (n + 1);
+            }
+        };
+    }  // namespace
+
+    TEST_CASE("event_loop call_every_fixed stays phase-locked", "[event_loop][call_every_fixed]") {
+        using namespace std::chrono_literals;
+
+        constexpr auto interval = 10ms;
+        constexpr int samples = 8;
+
+        auto loop = test_loop::make();
+        std::vector<clock::time_point> times;
+        std::promise<void> done;
+        auto fut = done.get_future();
+
+        // assigned on the loop thread, which is where the callback reads it
+        std::shared_ptr<test_loop::ev_watcher> watcher;
+        loop->call_get([&] {
+            watcher = loop->call_every_fixed(interval, [&] {
+                times.push_back(clock::now());
+                // variable callback cost that an EV_PERSIST ticker would accumulate as drift
+                std::this_thread::sleep_for(std::chrono::milliseconds{times.size() % 2 ? 6 : 1});
+                if (times.size() == samples) {
+                    watcher->stop();
+                    done.set_value();
+                }
+            });
+        });
+
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+
+        // a late first tick shifts every offset equally, so bound the spread rather than each offset;
+        // relative rescheduling would accumulate the callback cost (~3.5ms per tick here) instead
+        auto lo = clock::duration::max(), hi = clock::duration::min();
+        for (size_t i = 1; i < times.size(); ++i) {
+            auto offset = (times[i] - times[0]) - interval * static_cast<int>(i);
+            lo = std::min(lo, offset);
+            hi = std::max(hi, offset);
+        }
+        REQUIRE(hi - lo < interval);
+    }
+
+    TEST_CASE("event_loop call_every_fixed skips and reports missed ticks", "[event_loop][call_every_fixed]") {
+        using namespace std::chrono_literals;
+
+        constexpr auto interval = 5ms;
+
+        auto loop = test_loop::make();
+        std::vector<uint64_t> missed;
+        std::vector<clock::time_point> times;
+        std::promise<void> done;
+        auto fut = done.get_future();
+        tick_grid grid{.interval = interval};
+
+        // assigned on the loop thread, which is where the callback reads it
+        std::shared_ptr<test_loop::ev_watcher> watcher;
+        loop->call_get([&] {
+            grid.before = clock::now();
+            watcher = loop->call_every_fixed(
+                    interval,
+                    [&](uint64_t m) {
+                        missed.push_back(m);
+                        times.push_back(clock::now());
+                        if (missed.size() == 1) {
+                            std::this_thread::sleep_for(interval * 4 + 2ms);
+                        }
+                        else if (missed.size() == 3) {
+                            watcher->stop();
+                            done.set_value();
+                        }
+                    },
+                    tick_policy::skip);
+            grid.after = clock::now();
+        });
+
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+        REQUIRE(missed.size() == 3);
+        // the first callback overran the next tick's deadline by more than three periods
+        REQUIRE(missed[1] >= 3);
+
+        // each count matches when its tick ran, and the skipped ticks are not replayed: the next
+        // tick is for the first grid point after the late one
+        int64_t k{1};
+        for (size_t i = 0; i < times.size(); ++i) {
+            REQUIRE(grid.late_by(times[i], k, missed[i]));
+            k += 1 + static_cast<int64_t>(missed[i]);
+        }
+    }
+
+    TEST_CASE("event_loop call_every_fixed catches up missed ticks", "[event_loop][call_every_fixed]") {
+        using namespace std::chrono_literals;
+
+        constexpr auto interval = 5ms;
+
+        auto loop = test_loop::make();
+        std::vector<uint64_t> backlog;
+        std::vector<clock::time_point> times;
+        std::promise<void> done;
+        auto fut = done.get_future();
+        tick_grid grid{.interval = interval};
+
+        // assigned on the loop thread, which is where the callback reads it
+        std::shared_ptr<test_loop::ev_watcher> watcher;
+        loop->call_get([&] {
+            grid.before = clock::now();
+            watcher = loop->call_every_fixed(
+                    interval,
+                    [&](uint64_t m) {
+                        backlog.push_back(m);
+                        times.push_back(clock::now());
+                        if (backlog.size() == 1) {
+                            std::this_thread::sleep_for(interval * 4 + 2ms);
+                        }
+                        else if (backlog.size() == 6) {
+                            watcher->stop();
+                            done.set_value();
+                        }
+                    },
+                    tick_policy::catch_up);
+            grid.after = clock::now();
+        });
+
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+        REQUIRE(backlog.size() == 6);
+        REQUIRE(backlog[1] >= 3);
+
+        // every grid point gets its own tick, each reporting the backlog as of when it ran
+        for (size_t i = 0; i < times.size(); ++i) {
+            REQUIRE(grid.late_by(times[i], static_cast<int64_t>(i) + 1, backlog[i]));
+        }
+        // so a backlog shrinks by at most one per tick while the missed ones are replayed
+        for (size_t i = 2; i < backlog.size(); ++i) {
+            REQUIRE(backlog[i] + 1 >= backlog[i - 1]);
+        }
+    }
+}  // namespace un::event::test
@@ -0,0 +1,126 @@
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    TEST_CASE("event_loop ticker group dispatches every member per tick", "[event_loop][ticker_group]") {
+        using namespace std::chrono_literals;
+
+        constexpr size_t n = 1000;
+
+        auto loop = test_loop::make();
+        auto group = loop->make_ticker_group(5ms);
+
+        std::vector<int> counts(n, 0);
+        std::vector<test_loop::ticker_group::member> members;
+        // joined in one loop pass so no tick can land between two joins
+        loop->call_get([&] {
+            for (size_t i = 0; i < n; ++i) {
+                members.push_back(group->join([&counts, i] { ++counts[i]; }));
+            }
+        });
+        REQUIRE(loop->call_get([&] { return group->size(); }) == n);
+
+        std::this_thread::sleep_for(50ms);
+
+        loop->call_get([&] {
+            // every member sees exactly the same ticks
+            REQUIRE(counts[0] > 0);
+            for (auto c : counts) {
+                REQUIRE(c == counts[0]);
+            }
+        });
+
+        // drop the odd members; only the even ones keep ticking
+        for (size_t i = 1; i < n; i += 2) {
+            members[i].reset();
+        }
+        REQUIRE(loop->call_get([&] { return group->size(); }) == n / 2);
+
+        auto snapshot = loop->call_get([&] { return counts; });
+        std::this_thread::sleep_for(30ms);
+
+        loop->call_get([&] {
+            for (size_t i = 0; i < n; ++i) {
+                if (i % 2) {
+                    REQUIRE(counts[i] == snapshot[i]);
+                }
+                else {
+                    REQUIRE(counts[i] > snapshot[i]);
+                }
+            }
+        });
+
+        members.clear();
+        REQUIRE(loop->call_get([&] { return group->size(); }) == 0);
+    }
+
+    TEST_CASE("event_loop ticker group membership changes from inside a tick", "[event_loop][ticker_group]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        auto group = loop->make_ticker_group(2ms);
+
+        int self_leaver{0}, victim{0}, late{0}, survivor{0};
+        test_loop::ticker_group::member m_self, m_victim, m_late, m_survivor;
+        std::promise<void> done;
+        auto fut = done.get_future();
+
+        loop->call_get([&] {
+            m_self = group->join([&] {
+                ++self_leaver;
+                // leaving the group from the member's own callback; also removes a sibling that would
+                // otherwise run later in this same pass and adds a new member
+                m_self.reset();
+                m_victim.reset();
+                m_late = group->join([&] { ++late; });
+            });
+            m_victim = group->join([&] { ++victim; });
+            m_survivor = group->join([&] {
+                if (++survivor == 5) {
+                    done.set_value();
+                }
+            });
+        });
+
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+
+        loop->call_get([&] {
+            REQUIRE(self_leaver == 1);
+            REQUIRE(victim == 0);
+            // joined during the first pass, so first invoked on the second
+            REQUIRE(late == survivor - 1);
+            REQUIRE(group->size() == 2);
+
+            m_late.reset();
+            m_survivor.reset();
+            REQUIRE(group->size() == 0);
+        });
+    }
+
+    TEST_CASE("event_loop ticker group and its members may outlive the loop", "[event_loop][ticker_group]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        auto group = loop->make_ticker_group(1ms);
+
+        std::atomic<int> ticks{0};
+        auto m = group->join([&] { ++ticks; });
+        auto other = group->join([&] { ++ticks; });
+        REQUIRE(group->size() == 2);
+
+        loop.reset();
+        auto after = ticks.load();
+
+        m.reset();
+        REQUIRE_FALSE(group->join([&] { ++ticks; }));
+
+        group.reset();
+        other.reset();
+        REQUIRE(ticks.load() == after);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,103 @@
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace un::event::test {
+    namespace {
+        struct tracked {
+            std::atomic<int>& destroyed;
+            std::thread::id& destroyed_on;
+            int value;
+
+            ~tracked() {
+                destroyed_on = std::this_thread::get_id();
+                ++destroyed;
+            }
+        };
+    }  // namespace
+
+    TEST_CASE("event_loop local_ptr shares ownership on the loop thread", "[event_loop][local_ptr]") {
+        auto loop = test_loop::make();
+        std::atomic<int> destroyed{0};
+        std::thread::id destroyed_on;
+
+        loop->call_get([&] {
+            auto p = loop->make_local<tracked>(destroyed, destroyed_on, 42);
+            REQUIRE(p.use_count() == 1);
+            REQUIRE(p->value == 42);
+
+            {
+                auto q = p;
+                REQUIRE(p.use_count() == 2);
+                REQUIRE(q == p);
+
+                auto r = std::move(q);
+                REQUIRE_FALSE(q);
+                REQUIRE(r.use_count() == 2);
+            }
+
+            REQUIRE(p.use_count() == 1);
+            REQUIRE(destroyed == 0);
+
+            p.reset();
+            REQUIRE(destroyed == 1);
+            REQUIRE(p.use_count() == 0);
+        });
+    }
+
+    TEST_CASE("event_loop share() hands loop-local objects to other threads", "[event_loop][local_ptr]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        std::atomic<int> destroyed{0};
+        std::thread::id destroyed_on;
+
+        auto shared = loop->call_get([&] {
+            auto p = loop->make_local<tracked>(destroyed, destroyed_on, 7);
+            auto s = loop->share(p);
+            REQUIRE(p.use_count() == 2);
+            return s;
+        });
+
+        // the local copy above is gone; the shared handle alone keeps the object alive
+        REQUIRE(destroyed == 0);
+
+        int seen{0};
+        std::thread other{[&seen, s = std::move(shared)]() mutable {
+            seen = s->value;
+            auto copy = s;
+            s.reset();
+            copy.reset();
+        }};
+        other.join();
+        REQUIRE(seen == 7);
+
+        // the final local release is posted back to the loop
+        loop->call_get([] {});
+        REQUIRE(destroyed == 1);
+        REQUIRE(destroyed_on == loop->call_get([] { return std::this_thread::get_id(); }));
+    }
+
+    TEST_CASE("event_loop share() releases on the loop thread after shutdown", "[event_loop][local_ptr]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        std::atomic<int> destroyed{0};
+        std::thread::id destroyed_on;
+        auto loop_thread = loop->call_get([] { return std::this_thread::get_id(); });
+
+        auto shared =
+                loop->call_get([&] { return loop->share(loop->make_local<tracked>(destroyed, destroyed_on, 1)); });
+        loop->shutdown(1s);
+
+        // refused by call_soon now, but the local count must still only be touched by the loop
+        shared.reset();
+        for (int i = 0; i < 200 and destroyed == 0; ++i) {
+            std::this_thread::sleep_for(5ms);
+        }
+        REQUIRE(destroyed == 1);
+        REQUIRE(destroyed_on == loop_thread);
+    }
+}  // namespace un::event::test
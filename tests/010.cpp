@@ -0,0 +1,81 @@
+#include "utils.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    namespace {
+        struct pooled_object {
+            std::atomic<int>& destroyed;
+            std::thread::id& destroyed_on;
+            char payload[48]{};
+
+            ~pooled_object() {
+                destroyed_on = std::this_thread::get_id();
+                ++destroyed;
+            }
+        };
+    }  // namespace
+
+    TEST_CASE("object_pool recycles slots per size class", "[object_pool]") {
+        object_pool pool;
+
+        auto* a = pool.allocate(24, 8, true);
+        auto* b = pool.allocate(32, 8, true);
+        // same 32-byte class, distinct slots
+        REQUIRE(a != b);
+        REQUIRE(pool.reserved() == object_pool::chunk_size);
+
+        pool.deallocate(a, 24, 8, true);
+        REQUIRE(pool.allocate(30, 8, true) == a);
+
+        // frees from other threads are adopted by the owner once its own list runs dry
+        std::thread{[&] { pool.deallocate(b, 32, 8, false); }}.join();
+        std::vector<void*> taken;
+        bool reused{false};
+        for (size_t i = 0; i < object_pool::run_size / 32 + 1; ++i) {
+            auto* p = pool.allocate(32, 8, true);
+            reused = reused or p == b;
+            taken.push_back(p);
+        }
+        REQUIRE(reused);
+
+        for (auto* p : taken) {
+            pool.deallocate(p, 32, 8, true);
+        }
+
+        // oversized requests bypass the pool entirely
+        auto* big = pool.allocate(object_pool::max_size + 1, 8, true);
+        pool.deallocate(big, object_pool::max_size + 1, 8, true);
+        REQUIRE(pool.reserved() == object_pool::chunk_size);
+    }
+
+    TEST_CASE("event_loop make_shared allocates from the loop pool", "[event_loop][object_pool]") {
+        auto loop = test_loop::make();
+        std::atomic<int> destroyed{0};
+        std::thread::id destroyed_on;
+
+        auto loop_thread = loop->call_get([] { return std::this_thread::get_id(); });
+
+        // created off-loop and released off-loop: destruction still happens on the loop thread
+        {
+            auto p = loop->make_shared<pooled_object>(destroyed, destroyed_on);
+            REQUIRE(p->payload[0] == 0);
+        }
+        REQUIRE(destroyed == 1);
+        REQUIRE(destroyed_on == loop_thread);
+
+        loop->call_get([&] {
+            // on the loop thread a released block is handed straight back to the next allocation
+            const void* first;
+            {
+                auto p = loop->make_shared<pooled_object>(destroyed, destroyed_on);
+                first = p.get();
+            }
+            auto q = loop->make_shared<pooled_object>(destroyed, destroyed_on);
+            REQUIRE(static_cast<const void*>(q.get()) == first);
+        });
+        REQUIRE(destroyed == 3);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,121 @@
+#include "utils.hpp"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    TEST_CASE("event_loop channel delivers a batch on one wakeup", "[event_loop][channel]") {
+        using namespace std::chrono_literals;
+
+        auto consumer = test_loop::make();
+
+        std::vector<int> received;
+        size_t seen_at_marker{0};
+        std::promise<void> marker;
+
+        auto chan = consumer->make_channel<int, channel_mode::spsc>(16, [&](int&& v) {
+            if (received.empty()) {
+                // runs after the current drain pass, so it observes how many messages that pass took
+                consumer->call_soon([&] {
+                    seen_at_marker = received.size();
+                    marker.set_value();
+                });
+            }
+            received.push_back(v);
+        });
+        REQUIRE(chan->capacity() == 16);
+
+        // hold the consumer loop so every message queues up behind a single wakeup
+        std::promise<void> release;
+        consumer->call_soon([f = release.get_future().share()] { f.wait(); });
+
+        for (int i = 0; i < 16; ++i) {
+            REQUIRE(chan->try_send(i));
+        }
+        REQUIRE_FALSE(chan->try_send(16));
+
+        release.set_value();
+        REQUIRE(marker.get_future().wait_for(1s) == std::future_status::ready);
+
+        REQUIRE(seen_at_marker == 16);
+        consumer->call_get([&] {
+            REQUIRE(received.size() == 16);
+            for (int i = 0; i < 16; ++i) {
+                REQUIRE(received[i] == i);
+            }
+        });
+
+        // space is reclaimed once drained
+        REQUIRE(chan->try_send(16));
+    }
+
+    TEST_CASE("event_loop mpsc channel between loops", "[event_loop][channel]") {
+        using namespace std::chrono_literals;
+
+        constexpr int producers = 4;
+        constexpr int per_producer = 20'000;
+
+        struct message {
+            int producer;
+            int seq;
+            std::unique_ptr<int> payload;
+        };
+
+        auto consumer = test_loop::make();
+
+        std::vector<int> next(producers, 0);
+        bool in_order{true};
+        int64_t total{0};
+        std::promise<void> done;
+
+        auto chan = consumer->make_channel<message>(64, [&](message&& m) {
+            in_order = in_order and m.seq == next[m.producer];
+            next[m.producer] = m.seq + 1;
+            total += *m.payload;
+            if (total == int64_t{producers} * per_producer) {
+                done.set_value();
+            }
+        });
+
+        std::vector<std::shared_ptr<test_loop>> loops;
+        for (int p = 0; p < producers; ++p) {
+            auto l = test_loop::make();
+            l->call_soon([p, chan] {
+                for (int i = 0; i < per_producer; ++i) {
+                    while (not chan->try_emplace(p, i, std::make_unique<int>(1))) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            loops.push_back(std::move(l));
+        }
+
+        REQUIRE(done.get_future().wait_for(10s) == std::future_status::ready);
+        consumer->call_get([&] {
+            REQUIRE(in_order);
+            for (auto n : next) {
+                REQUIRE(n == per_producer);
+            }
+        });
+    }
+
+    TEST_CASE("event_loop channel may outlive its consumer loop", "[event_loop][channel]") {
+        auto consumer = test_loop::make();
+        int handled{0};
+        auto chan = consumer->make_channel<std::unique_ptr<int>>(4, [&](std::unique_ptr<int>&&) { ++handled; });
+
+        REQUIRE(chan->try_send(std::make_unique<int>(1)));
+        consumer->call_get([] {});
+        consumer.reset();
+        REQUIRE(handled == 1);
+
+        // nothing is woken any more; what is sent waits in the ring and is freed with the channel
+        REQUIRE(chan->try_send(std::make_unique<int>(2)));
+        REQUIRE(chan->try_send(std::make_unique<int>(3)));
+        chan.reset();
+        REQUIRE(handled == 1);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,106 @@
+#include "utils.hpp"
+
+#include <chrono>
+#include <future>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace un::event::test {
+    using test_pool = loop_pool<test_channel>;
+
+    TEST_CASE("exec schedule runs the continuation on the loop thread", "[exec]") {
+        auto loop = test_loop::make();
+        auto sched = exec::get_scheduler(*loop);
+
+        auto loop_thread = loop->call_get([] { return std::this_thread::get_id(); });
+
+        auto r = exec::sync_wait(sched.schedule() | exec::then([] { return std::this_thread::get_id(); }));
+        REQUIRE(r.has_value());
+        REQUIRE(*r == loop_thread);
+
+        // values flow through a chain of continuations
+        auto v = exec::sync_wait(
+                sched.schedule() | exec::then([] { return 20; }) | exec::then([](int x) { return x * 2 + 2; }));
+        REQUIRE(v == 42);
+
+        // a void chain yields monostate
+        int side{0};
+        auto u = exec::sync_wait(exec::then(sched.schedule(), [&] { side = 1; }));
+        REQUIRE(u.has_value());
+        REQUIRE(side == 1);
+    }
+
+    TEST_CASE("exec then propagates exceptions as errors", "[exec]") {
+        auto loop = test_loop::make();
+        auto sched = exec::get_scheduler(*loop);
+
+        bool reached{false};
+        auto s = sched.schedule() | exec::then([]() -> int { throw std::runtime_error{"boom"}; }) |
+                 exec::then([&](int) {
+                     reached = true;
+                     return 0;
+                 });
+
+        REQUIRE_THROWS_AS(exec::sync_wait(std::move(s)), std::runtime_error);
+        REQUIRE_FALSE(reached);
+    }
+
+    TEST_CASE("exec schedule_after waits on the loop's timer", "[exec]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        auto sched = exec::get_scheduler(*loop);
+
+        auto start = std::chrono::steady_clock::now();
+        auto r = exec::sync_wait(sched.schedule_after(20ms) | exec::then([&] { return loop->in_event_loop(); }));
+
+        REQUIRE(std::chrono::steady_clock::now() - start >= 20ms);
+        REQUIRE(r == true);
+    }
+
+    TEST_CASE("exec schedule_after stops when the loop shuts down first", "[exec][lifecycle]") {
+        using namespace std::chrono_literals;
+
+        auto wait_on = [](test_loop& loop) {
+            return std::async(std::launch::async, [sched = exec::get_scheduler(loop)] {
+                return exec::sync_wait(sched.schedule_after(10s));
+            });
+        };
+
+        auto loop = test_loop::make();
+        auto waiter = wait_on(*loop);
+        REQUIRE(waiter.wait_for(20ms) == std::future_status::timeout);
+
+        // a drain does not wait for it, and the close stops it
+        auto report = loop->shutdown(1s);
+        REQUIRE_FALSE(report.timed_out);
+        REQUIRE(waiter.wait_for(1s) == std::future_status::ready);
+        REQUIRE_FALSE(waiter.get().has_value());
+
+        // refused once the loop has shut down
+        REQUIRE_FALSE(exec::sync_wait(exec::get_scheduler(*loop).schedule_after(10s)).has_value());
+
+        // and disarmed before the base is freed when the loop is simply destroyed
+        loop = test_loop::make();
+        waiter = wait_on(*loop);
+        REQUIRE(waiter.wait_for(20ms) == std::future_status::timeout);
+        loop.reset();
+        REQUIRE(waiter.wait_for(1s) == std::future_status::ready);
+        REQUIRE_FALSE(waiter.get().has_value());
+    }
+
+    TEST_CASE("exec loop_pool scheduler spreads work across loops", "[exec][loop_pool]") {
+        test_pool pool{3};
+        REQUIRE(pool.size() == 3);
+
+        auto sched = exec::get_scheduler(pool);
+
+        std::set<std::thread::id> threads;
+        for (int i = 0; i < 6; ++i) {
+            auto r = exec::sync_wait(sched.schedule() | exec::then([] { return std::this_thread::get_id(); }));
+            threads.insert(*r);
+        }
+        REQUIRE(threads.size() == 3);
+    }
+}  // namespace un::event::test
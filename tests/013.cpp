@@ -0,0 +1,114 @@
+#include "utils.hpp"
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace un::event::test {
+    TEST_CASE("event_loop call_async continues on the requesting loop", "[event_loop][call_async]") {
+        using namespace std::chrono_literals;
+
+        auto a = test_loop::make();
+        auto b = test_loop::make();
+
+        auto a_thread = a->call_get([] { return std::this_thread::get_id(); });
+        auto b_thread = b->call_get([] { return std::this_thread::get_id(); });
+
+        std::promise<std::pair<int, bool>> result;
+
+        // loop a asks loop b for work and is handed the answer back without ever blocking
+        a->call_soon([&] {
+            b->call_async([&] { return std::pair{21, std::this_thread::get_id() == b_thread}; })
+                    .then(*a,
+                          [&](std::pair<int, bool> r) {
+                              return std::pair{r.first * 2, r.second and std::this_thread::get_id() == a_thread};
+                          })
+                    .then(*a, [&](std::pair<int, bool> r) { result.set_value(r); });
+        });
+
+        auto fut = result.get_future();
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+        auto [value, on_expected_threads] = fut.get();
+        REQUIRE(value == 42);
+        REQUIRE(on_expected_threads);
+    }
+
+    TEST_CASE("event_loop call_async attaches to an already ready result", "[event_loop][call_async]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+
+        auto f = loop->call_async([] { return std::string{"ready"}; });
+        loop->call_get([] {});
+        REQUIRE(f.ready());
+
+        std::promise<std::string> done;
+        auto next = std::move(f).then(*loop, [&](std::string s) { done.set_value(s + "!"); });
+        REQUIRE_FALSE(f.valid());
+        REQUIRE(next.valid());
+
+        auto fut = done.get_future();
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+        REQUIRE(fut.get() == "ready!");
+    }
+
+    TEST_CASE("event_loop call_async propagates exceptions past continuations", "[event_loop][call_async]") {
+        using namespace std::chrono_literals;
+
+        auto a = test_loop::make();
+        auto b = test_loop::make();
+
+        bool skipped{true};
+        std::promise<std::string> caught;
+
+        b->call_async([]() -> int { throw std::runtime_error{"producer failed"}; })
+                .then(*a,
+                      [&](int) {
+                          skipped = false;
+                          return 0;
+                      })
+                .then_or_error(*a, [&](std::exception_ptr e) {
+                    try {
+                        std::rethrow_exception(e);
+                    } catch (const std::exception& ex) {
+                        caught.set_value(ex.what());
+                    }
+                });
+
+        auto fut = caught.get_future();
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+        REQUIRE(fut.get() == "producer failed");
+        REQUIRE(a->call_get([&] { return skipped; }));
+    }
+
+    TEST_CASE("event_loop call_async fails continuations on a shut down loop", "[event_loop][call_async]") {
+        using namespace std::chrono_literals;
+
+        auto a = test_loop::make();
+        auto b = test_loop::make();
+        auto c = test_loop::make();
+
+        auto f = b->call_async([] { return 1; });
+        a->shutdown(1s);
+
+        bool skipped{true};
+        std::promise<std::string> caught;
+
+        std::move(f)
+                .then(*a, [&](int) { skipped = false; })
+                .then_or_error(*c, [&](std::exception_ptr e) {
+                    try {
+                        std::rethrow_exception(e);
+                    } catch (const std::exception& ex) {
+                        caught.set_value(ex.what());
+                    }
+                });
+
+        auto fut = caught.get_future();
+        REQUIRE(fut.wait_for(1s) == std::future_status::ready);
+        REQUIRE(fut.get() == "Loop is shutting down");
+        REQUIRE(skipped);
+    }
+}  // namespace un::event::test
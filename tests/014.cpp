@@ -0,0 +1,154 @@
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace un::event::test {
+    TEST_CASE("event_loop shutdown drains queued jobs and due timers", "[event_loop][shutdown]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        std::atomic<int> jobs{0};
+        std::atomic<bool> due_fired{false}, late_fired{false};
+
+        // keep the loop busy so that shutdown begins with work still queued
+        loop->call_soon([] { std::this_thread::sleep_for(30ms); });
+        for (int i = 0; i < 50; ++i) {
+            REQUIRE(loop->call_soon([&] { ++jobs; }));
+        }
+        // follow-up work queued from the loop thread during the drain is still accepted
+        loop->call_soon([&] { loop->call_soon([&] { ++jobs; }); });
+        loop->call_get([&] {
+            loop->call_later(60ms, [&] { due_fired = true; });
+            loop->call_later(10s, [&] { late_fired = true; });
+        });
+
+        shutdown_report report;
+        std::thread stopper{[&] { report = loop->shutdown(2s); }};
+
+        // once the drain has begun, posts from other threads bounce
+        auto give_up = std::chrono::steady_clock::now() + 1s;
+        while (loop->call_soon([&] { ++jobs; }) and std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::yield();
+        }
+        auto accepted_before_drain = jobs.load();
+
+        stopper.join();
+
+        REQUIRE_FALSE(report.timed_out);
+        REQUIRE(report.jobs_dropped == 0);
+        REQUIRE(report.timers_dropped == 1);
+        REQUIRE(report.posts_rejected >= 1);
+        REQUIRE(due_fired);
+        REQUIRE_FALSE(late_fired);
+        REQUIRE(jobs >= 51);
+        REQUIRE(jobs >= accepted_before_drain);
+
+        // shut down for good: nothing more is accepted and call_get runs inline
+        REQUIRE_FALSE(loop->call_soon([] {}));
+        REQUIRE(loop->call_get([] { return std::this_thread::get_id(); }) == std::this_thread::get_id());
+        REQUIRE(loop->shutdown(1s).jobs_dropped == 0);
+    }
+
+    TEST_CASE("event_loop shutdown stops at its deadline", "[event_loop][shutdown]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        std::atomic<int> ran{0};
+
+        std::promise<void> started;
+        loop->call_soon([&] {
+            started.set_value();
+            std::this_thread::sleep_for(50ms);
+        });
+        for (int i = 0; i < 10; ++i) {
+            loop->call_soon([&] { ++ran; });
+        }
+        started.get_future().wait();
+
+        auto report = loop->shutdown(10ms);
+
+        REQUIRE(report.timed_out);
+        // the blocking job outlasted the deadline, so the jobs behind it never ran
+        REQUIRE(ran == 0);
+        REQUIRE(report.jobs_dropped == 10);
+    }
+
+    TEST_CASE("event_loop shutdown cancel drops pending work", "[event_loop][shutdown]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        std::atomic<int> ran{0};
+
+        loop->call_get([&] {
+            loop->call_later(5ms, [&] { ++ran; });
+            loop->call_later(10ms, [&] { ++ran; });
+        });
+        std::promise<void> started;
+        loop->call_soon([&] {
+            started.set_value();
+            std::this_thread::sleep_for(20ms);
+        });
+        for (int i = 0; i < 5; ++i) {
+            loop->call_soon([&] { ++ran; });
+        }
+        started.get_future().wait();
+
+        auto report = loop->shutdown(1s, shutdown_policy::cancel);
+
+        REQUIRE_FALSE(report.timed_out);
+        REQUIRE(report.jobs_dropped == 5);
+        // the timers came due while the loop was blocked but never got to run
+        REQUIRE(report.timers_dropped == 2);
+        REQUIRE(ran == 0);
+    }
+
+    TEST_CASE("event_loop shutdown cancel settles dropped call_get and call_async", "[event_loop][shutdown]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        auto other = test_loop::make();
+
+        std::promise<void> started, release;
+        loop->call_soon([&, gate = release.get_future().share()] {
+            started.set_value();
+            gate.wait();
+        });
+        started.get_future().wait();
+
+        std::atomic<bool> async_ran{false};
+        std::promise<std::string> failure;
+        auto fut = loop->call_async([&] {
+                           async_ran = true;
+                           return 1;
+                       }).then_or_error(*other, [&](std::exception_ptr e) {
+                             try {
+                                 std::rethrow_exception(e);
+                             } catch (const std::exception& ex) {
+                                 failure.set_value(ex.what());
+                             }
+                         });
+
+        auto getter = std::async(std::launch::async, [&] { return loop->call_get([] { return 7; }); });
+        // let the call_get land in the queue behind the blocking job
+        std::this_thread::sleep_for(20ms);
+        auto closer = std::async(std::launch::async, [&] { return loop->shutdown(1s, shutdown_policy::cancel); });
+        std::this_thread::sleep_for(20ms);
+        release.set_value();
+
+        REQUIRE(closer.wait_for(2s) == std::future_status::ready);
+        REQUIRE(closer.get().jobs_dropped >= 1);
+        // the dropped call_get ran on its own thread rather than leaving the caller blocked
+        REQUIRE(getter.wait_for(2s) == std::future_status::ready);
+        REQUIRE(getter.get() == 7);
+
+        auto message = failure.get_future();
+        REQUIRE(message.wait_for(2s) == std::future_status::ready);
+        REQUIRE(message.get() == "Loop is shutting down");
+        REQUIRE_FALSE(async_ran);
+    }
+}  // namespace un::event::test
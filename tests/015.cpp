@@ -0,0 +1,114 @@
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    using test_pool = loop_pool<test_channel>;
+
+    TEST_CASE("parallel_for covers the range exactly once across loops", "[parallel][loop_pool]") {
+        test_pool pool{3};
+
+        constexpr int n = 100'000;
+        std::vector<std::atomic<int>> hits(n);
+
+        parallel_for(pool, 0, n, [&](int i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+
+        for (auto& h : hits) {
+            REQUIRE(h.load() == 1);
+        }
+
+        // work that takes a while is spread over the loops as well as the caller
+        std::mutex threads_mutex;
+        std::set<std::thread::id> threads;
+        parallel_for(pool, 0, 200, [&](int) {
+            std::this_thread::sleep_for(std::chrono::microseconds{200});
+            std::lock_guard lock{threads_mutex};
+            threads.insert(std::this_thread::get_id());
+        });
+        REQUIRE(threads.size() > 1);
+
+        // range form: chunks tile the range without gaps or overlap
+        std::mutex chunks_mutex;
+        std::vector<std::pair<int64_t, int64_t>> chunks;
+        parallel_for(
+                pool,
+                int64_t{10},
+                int64_t{5'010},
+                [&](int64_t b, int64_t e) {
+                    std::lock_guard lock{chunks_mutex};
+                    chunks.emplace_back(b, e);
+                },
+                {.min_grain = 16});
+
+        std::ranges::sort(chunks);
+        REQUIRE(chunks.front().first == 10);
+        REQUIRE(chunks.back().second == 5'010);
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            REQUIRE(chunks[i].first == chunks[i - 1].second);
+            // only the final chunk may fall short of the minimum grain
+            REQUIRE(chunks[i - 1].second - chunks[i - 1].first >= 16);
+        }
+
+        // an empty range never calls the body
+        parallel_for(pool, 5, 5, [](int) { throw std::logic_error{"unreachable"}; });
+    }
+
+    TEST_CASE("parallel_reduce combines chunks in order", "[parallel][loop_pool]") {
+        test_pool pool{4};
+
+        auto sum = parallel_reduce(
+                pool, uint64_t{1}, uint64_t{1'000'001}, uint64_t{0}, [](uint64_t i) { return i; }, std::plus<>{});
+        REQUIRE(sum == uint64_t{1'000'000} * 1'000'001 / 2);
+
+        // string concatenation is associative but not commutative
+        auto s = parallel_reduce(
+                pool,
+                0,
+                500,
+                std::string{},
+                [](int i) { return std::string(1, static_cast<char>('a' + i % 26)); },
+                [](std::string a, const std::string& b) { return a + b; },
+                {.min_grain = 7});
+        REQUIRE(s.size() == 500);
+        for (size_t i = 0; i < s.size(); ++i) {
+            REQUIRE(s[i] == static_cast<char>('a' + i % 26));
+        }
+    }
+
+    TEST_CASE("parallel_for rethrows the first failure", "[parallel][loop_pool]") {
+        test_pool pool{2};
+        std::atomic<int> ran{0};
+
+        REQUIRE_THROWS_AS(
+                parallel_for(pool, 0, 10'000, [&](int i) {
+                    ++ran;
+                    if (i == 1'234) {
+                        throw std::runtime_error{"bad element"};
+                    }
+                }),
+                std::runtime_error);
+        REQUIRE(ran >= 1);
+
+        // the pool is still usable afterwards
+        auto total = parallel_reduce(pool, 0, 100, 0, [](int) { return 1; }, std::plus<>{});
+        REQUIRE(total == 100);
+    }
+
+    TEST_CASE("parallel_for from a pool loop does its share inline", "[parallel][loop_pool]") {
+        test_pool pool{2};
+
+        // the calling loop is blocked for the duration, so its chunks must run on the caller itself
+        auto sum = pool[0]->call_get([&] {
+            return parallel_reduce(pool, 0, 10'000, int64_t{0}, [](int i) { return int64_t{i}; }, std::plus<>{});
+        });
+        REQUIRE(sum == int64_t{9'999} * 10'000 / 2);
+    }
+}  // namespace un::event::test
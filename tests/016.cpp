@@ -0,0 +1,158 @@
+#include "utils.hpp"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace un::event::test {
+    TEST_CASE("event_loop call_blocking runs off the loop and completes on it", "[event_loop][blocking]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        auto loop_thread = loop->call_get([] { return std::this_thread::get_id(); });
+
+        std::promise<std::thread::id> worker;
+        std::promise<std::pair<int, std::thread::id>> got;
+        REQUIRE(loop->call_blocking(
+                [&] {
+                    worker.set_value(std::this_thread::get_id());
+                    return 42;
+                },
+                [&](blocking_result<int> r) { got.set_value({r.value_or(-1), std::this_thread::get_id()}); }));
+
+        auto [value, done_thread] = got.get_future().get();
+        REQUIRE(value == 42);
+        REQUIRE(done_thread == loop_thread);
+        REQUIRE(worker.get_future().get() != loop_thread);
+
+        // exceptions come back as the error
+        std::promise<std::string> error;
+        loop->call_blocking([]() -> void { throw std::runtime_error{"disk on fire"}; }, [&](blocking_result<void> r) {
+            try {
+                std::rethrow_exception(r.error());
+            } catch (const std::exception& e) {
+                error.set_value(e.what());
+            }
+        });
+        REQUIRE(error.get_future().get() == "disk on fire");
+
+        // move-only results are handed over by value
+        std::promise<int> moved;
+        loop->call_blocking(
+                [] { return std::make_unique<int>(7); },
+                [&](blocking_result<std::unique_ptr<int>> r) { moved.set_value(**r); });
+        REQUIRE(moved.get_future().get() == 7);
+    }
+
+    TEST_CASE("event_loop call_blocking keeps the loop responsive", "[event_loop][blocking]") {
+        using namespace std::chrono_literals;
+
+        loop_options opts;
+        opts.blocking = std::make_shared<blocking_pool>(2);
+        auto loop = test_loop::make(opts);
+
+        constexpr int n = 20;
+        std::atomic<int> completed{0};
+        std::promise<void> all_done;
+
+        for (int i = 0; i < n; ++i) {
+            loop->call_blocking(
+                    [] { std::this_thread::sleep_for(5ms); },
+                    [&](blocking_result<void>) {
+                        if (++completed == n) {
+                            all_done.set_value();
+                        }
+                    });
+        }
+
+        // the loop keeps serving jobs while the helpers are busy
+        auto start = std::chrono::steady_clock::now();
+        loop->call_get([] {});
+        REQUIRE(std::chrono::steady_clock::now() - start < 5ms * n);
+
+        REQUIRE(all_done.get_future().wait_for(5s) == std::future_status::ready);
+        REQUIRE(opts.blocking->threads() == 2);
+    }
+
+    TEST_CASE("event_loop file read/write round trip", "[event_loop][blocking]") {
+        auto loop = test_loop::make();
+        auto path = std::filesystem::temp_directory_path() / ("unevent-test-" + std::to_string(::getpid()));
+
+        std::string payload(100'000, 'x');
+        for (size_t i = 0; i < payload.size(); i += 97) {
+            payload[i] = static_cast<char>('a' + i % 26);
+        }
+
+        std::promise<bool> wrote;
+        loop->write_file(path, payload, [&](blocking_result<void> r) { wrote.set_value(r.has_value()); }, {.sync = true});
+        REQUIRE(wrote.get_future().get());
+
+        std::promise<bool> appended;
+        loop->write_file(path, "tail", [&](blocking_result<void> r) { appended.set_value(r.has_value()); }, {.append = true});
+        REQUIRE(appended.get_future().get());
+
+        std::promise<std::string> read;
+        loop->read_file(path, [&](blocking_result<std::string> r) { read.set_value(r.value_or("")); });
+        REQUIRE(read.get_future().get() == payload + "tail");
+
+        std::filesystem::remove(path);
+
+        std::promise<std::error_code> missing;
+        loop->read_file(path, [&](blocking_result<std::string> r) {
+            try {
+                std::rethrow_exception(r.error());
+            } catch (const std::system_error& e) {
+                missing.set_value(e.code());
+            }
+        });
+        REQUIRE(missing.get_future().get() == std::errc::no_such_file_or_directory);
+    }
+
+    TEST_CASE("event_loop draining shutdown waits for blocking work", "[event_loop][blocking][shutdown]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        std::atomic<bool> delivered{false};
+
+        loop->call_blocking([] { std::this_thread::sleep_for(20ms); }, [&](blocking_result<void>) { delivered = true; });
+
+        auto report = loop->shutdown(2s);
+        REQUIRE_FALSE(report.timed_out);
+        REQUIRE(delivered);
+
+        REQUIRE_FALSE(loop->call_blocking([] {}, [](blocking_result<void>) {}));
+    }
+
+    TEST_CASE("event_loop call_blocking work may hold the last loop reference", "[event_loop][blocking]") {
+        using namespace std::chrono_literals;
+
+        loop_options opts;
+        opts.blocking = std::make_shared<blocking_pool>(1);
+        std::weak_ptr<blocking_pool> pool = opts.blocking;
+        auto loop = test_loop::make(opts);
+        opts.blocking.reset();
+        std::weak_ptr<test_loop> weak = loop;
+
+        std::promise<void> release;
+        REQUIRE(loop->call_blocking(
+                [l = loop, gate = release.get_future().share()] { gate.wait(); }, [](blocking_result<void>) {}));
+        loop.reset();
+        release.set_value();
+
+        // the helper thread destroys the loop and, with the loop's options, its own pool
+        auto give_up = std::chrono::steady_clock::now() + 2s;
+        while (not pool.expired() and std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(weak.expired());
+        REQUIRE(pool.expired());
+    }
+}  // namespace un::event::test
@@ -0,0 +1,142 @@
+#include "utils.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace un::event::test {
+    namespace {
+        struct transfer_fixture {
+            std::filesystem::path path;
+            std::string contents;
+            int file{-1};
+            int sock[2]{-1, -1};
+
+            explicit transfer_fixture(size_t size) :
+                    path{std::filesystem::temp_directory_path() / ("unevent-xfer-" + std::to_string(::getpid()))} {
+                contents.resize(size);
+                for (size_t i = 0; i < size; ++i) {
+                    contents[i] = static_cast<char>((i * 131) ^ (i >> 9));
+                }
+                detail::write_whole_file(path, contents, false, false);
+
+                file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sock);
+                ::fcntl(sock[0], F_SETFL, ::fcntl(sock[0], F_GETFL) | O_NONBLOCK);
+            }
+
+            ~transfer_fixture() {
+                ::close(file);
+                ::close(sock[0]);
+                ::close(sock[1]);
+                std::filesystem::remove(path);
+            }
+
+            // Drains the receiving end on its own thread until `n` bytes have arrived
+            std::future<std::string> receive(size_t n) {
+                return std::async(std::launch::async, [this, n] {
+                    std::string got;
+                    char buf[65536];
+                    while (got.size() < n) {
+                        auto r = ::read(sock[1], buf, sizeof(buf));
+                        if (r <= 0) {
+                            break;
+                        }
+                        got.append(buf, static_cast<size_t>(r));
+                    }
+                    return got;
+                });
+            }
+        };
+    }  // namespace
+
+    TEST_CASE("event_loop send_file streams a file through a full socket", "[event_loop][transfer]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        transfer_fixture fx{8U << 20};
+
+        for (bool splice : {false, true}) {
+            // start with nobody reading, so the transfer must park on EAGAIN and resume on an edge
+            std::promise<std::pair<std::error_code, size_t>> done;
+            auto t = loop->send_file(
+                    fx.sock[0],
+                    fx.file,
+                    0,
+                    file_transfer::to_end,
+                    [&](std::error_code ec, size_t n) { done.set_value({ec, n}); },
+                    {.slice = 256U << 10, .splice = splice});
+
+            std::this_thread::sleep_for(10ms);
+            REQUIRE(loop->call_get([&] { return not t->finished() and t->sent() < fx.contents.size(); }));
+
+            auto received = fx.receive(fx.contents.size());
+
+            auto fut = done.get_future();
+            REQUIRE(fut.wait_for(10s) == std::future_status::ready);
+            auto [ec, n] = fut.get();
+            REQUIRE_FALSE(ec);
+            REQUIRE(n == fx.contents.size());
+            REQUIRE(received.get() == fx.contents);
+        }
+    }
+
+    TEST_CASE("event_loop send_file honours offset, count and cancel", "[event_loop][transfer]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        transfer_fixture fx{1U << 20};
+
+        std::promise<size_t> ranged;
+        auto received = fx.receive(1000);
+        loop->send_file(fx.sock[0], fx.file, 4096, 1000, [&](std::error_code ec, size_t n) {
+            ranged.set_value(ec ? 0 : n);
+        });
+        REQUIRE(ranged.get_future().get() == 1000);
+        REQUIRE(received.get() == fx.contents.substr(4096, 1000));
+
+        // nobody reads: the transfer stalls on a full socket until cancelled
+        std::promise<std::error_code> cancelled;
+        auto t = loop->send_file(fx.sock[0], fx.file, 0, file_transfer::to_end, [&](std::error_code ec, size_t) {
+            cancelled.set_value(ec);
+        });
+        std::this_thread::sleep_for(10ms);
+        loop->call_get([&] { t->cancel(); });
+        REQUIRE(cancelled.get_future().get() == std::errc::operation_canceled);
+        REQUIRE(loop->call_get([&] { return t->finished(); }));
+    }
+
+    TEST_CASE("event_loop destruction cancels running transfers", "[event_loop][transfer]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        transfer_fixture fx{1U << 20};
+
+        // nobody reads, so both transfers are still parked on a full socket when the loop goes away
+        std::promise<std::error_code> dropped, held;
+        loop->send_file(fx.sock[0], fx.file, 0, file_transfer::to_end, [&](std::error_code ec, size_t) {
+            dropped.set_value(ec);
+        });
+        auto t = loop->send_file(fx.sock[0], fx.file, 0, file_transfer::to_end, [&](std::error_code ec, size_t) {
+            held.set_value(ec);
+        });
+        std::this_thread::sleep_for(10ms);
+
+        loop.reset();
+
+        auto first = dropped.get_future();
+        REQUIRE(first.wait_for(0s) == std::future_status::ready);
+        REQUIRE(first.get() == std::errc::operation_canceled);
+        REQUIRE(held.get_future().get() == std::errc::operation_canceled);
+        // the handle outlives the base its event belonged to
+        REQUIRE(t->finished());
+        t.reset();
+    }
+}  // namespace un::event::test
@@ -0,0 +1,74 @@
+#include "utils.hpp"
+
+#include <pthread.h>
+#include <signal.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace un::event::test {
+    TEST_CASE("event_loop on_signal coalesces queued signals into one callback", "[event_loop][signal]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        auto loop_thread = loop->call_get([] { return ::pthread_self(); });
+
+        std::atomic<int> calls{0};
+        std::atomic<uint32_t> total{0};
+        std::promise<void> got_all;
+
+        // real-time signals queue rather than merge, so every delivery is counted
+        auto signo = SIGRTMIN + 3;
+        auto w = loop->on_signal(signo, [&](uint32_t n) {
+            ++calls;
+            if ((total += n) == 5) {
+                got_all.set_value();
+            }
+        });
+        REQUIRE(w);
+
+        // hold the loop so that all five are queued on the signalfd before it is read; signals
+        // are aimed at the loop thread so no other thread in the test binary can take them
+        std::promise<void> release;
+        loop->call_soon([f = release.get_future().share()] { f.wait(); });
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(::pthread_kill(loop_thread, signo) == 0);
+        }
+        release.set_value();
+
+        REQUIRE(got_all.get_future().wait_for(1s) == std::future_status::ready);
+        loop->call_get([] {});
+        REQUIRE(calls == 1);
+        REQUIRE(total == 5);
+
+        // unregistering stops delivery
+        w.reset();
+        REQUIRE(::pthread_kill(loop_thread, signo) == 0);
+        std::this_thread::sleep_for(10ms);
+        loop->call_get([] {});
+        REQUIRE(total == 5);
+    }
+
+    TEST_CASE("event_loop signals belong to a single loop", "[event_loop][signal]") {
+        auto a = test_loop::make();
+        auto b = test_loop::make();
+
+        auto signo = SIGRTMIN + 4;
+        auto w1 = a->on_signal(signo, [](uint32_t) {});
+        // the same loop may watch it more than once
+        auto w2 = a->on_signal(signo, [](uint32_t) {});
+        REQUIRE_THROWS_AS(b->on_signal(signo, [](uint32_t) {}), std::logic_error);
+
+        // free again once every watcher on the owning loop is gone
+        w1.reset();
+        REQUIRE_THROWS_AS(b->on_signal(signo, [](uint32_t) {}), std::logic_error);
+        w2.reset();
+        auto w3 = b->on_signal(signo, [](uint32_t) {});
+        REQUIRE(w3);
+
+        REQUIRE_THROWS_AS(a->on_signal(SIGKILL, [](uint32_t) {}), std::invalid_argument);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,154 @@
+#include "utils.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    namespace {
+        // Reads from `fd` on a separate thread until `n` bytes have arrived, returning how long it took
+        std::future<std::chrono::steady_clock::duration> drain(int fd, size_t n) {
+            return std::async(std::launch::async, [fd, n] {
+                auto start = std::chrono::steady_clock::now();
+                char buf[16384];
+                size_t got{0};
+                while (got < n) {
+                    auto r = ::read(fd, buf, sizeof(buf));
+                    if (r <= 0) {
+                        break;
+                    }
+                    got += static_cast<size_t>(r);
+                }
+                return std::chrono::steady_clock::now() - start;
+            });
+        }
+    }  // namespace
+
+    TEST_CASE("event_loop stream round trip", "[event_loop][stream]") {
+        auto loop = test_loop::make();
+
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0);
+
+        auto s = loop->make_stream(fds[0]);
+        std::promise<std::string> echoed;
+        std::promise<std::error_code> closed;
+        loop->call_get([&] {
+            s->on_data([&](test_loop::stream& st) { echoed.set_value(st.read_all()); });
+            s->on_close([&](test_loop::stream&, std::error_code ec) { closed.set_value(ec); });
+        });
+
+        REQUIRE(::write(fds[1], "ping", 4) == 4);
+        REQUIRE(echoed.get_future().get() == "ping");
+
+        REQUIRE(loop->call_get([&] { return s->write("pong"); }));
+        char buf[4];
+        REQUIRE(::read(fds[1], buf, 4) == 4);
+        REQUIRE(std::string_view{buf, 4} == "pong");
+
+        ::close(fds[1]);
+        REQUIRE_FALSE(closed.get_future().get());
+        REQUIRE_FALSE(loop->call_get([&] { return s->is_open() or s->write("late"); }));
+
+        s.reset();
+    }
+
+    TEST_CASE("event_loop stream rate limit shapes egress", "[event_loop][stream][rate_limit]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0);
+        auto s = loop->make_stream(fds[0]);
+
+        // 20KiB up front, then 200KiB/s: 60KiB needs at least 200ms
+        constexpr size_t total = 60 * 1024;
+        auto took = drain(fds[1], total);
+        loop->call_get([&] {
+            s->set_rate_limit({.write_rate = 200 * 1024, .write_burst = 20 * 1024, .tick = 10ms});
+            s->write(std::string(total, 'r'));
+        });
+
+        auto elapsed = took.get();
+        REQUIRE(elapsed >= 180ms);
+        REQUIRE(elapsed < 2s);
+
+        s.reset();
+        ::close(fds[1]);
+    }
+
+    TEST_CASE("event_loop rate limit group caps aggregate egress", "[event_loop][stream][rate_limit]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        auto group = loop->make_rate_limit_group({.write_rate = 300 * 1024, .write_burst = 30 * 1024, .tick = 10ms});
+
+        constexpr int n = 3;
+        constexpr size_t each = 40 * 1024;
+
+        std::vector<std::shared_ptr<test_loop::stream>> streams;
+        std::vector<int> peers;
+        std::vector<std::future<std::chrono::steady_clock::duration>> took;
+
+        for (int i = 0; i < n; ++i) {
+            int fds[2];
+            REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0);
+            streams.push_back(loop->make_stream(fds[0]));
+            peers.push_back(fds[1]);
+            took.push_back(drain(fds[1], each));
+        }
+
+        // 120KiB through one 300KiB/s bucket holding 30KiB: at least 300ms for the last byte
+        loop->call_get([&] {
+            for (auto& s : streams) {
+                s->join(group);
+                s->write(std::string(each, 'g'));
+            }
+        });
+
+        std::chrono::steady_clock::duration slowest{};
+        for (auto& t : took) {
+            slowest = std::max(slowest, t.get());
+        }
+        REQUIRE(slowest >= 270ms);
+        REQUIRE(slowest < 3s);
+        REQUIRE(loop->call_get([&] { return group->totals().second; }) == n * each);
+
+        streams.clear();
+        group.reset();
+        for (auto fd : peers) {
+            ::close(fd);
+        }
+    }
+
+    TEST_CASE("event_loop stream holding the last group reference dies on the loop thread",
+              "[event_loop][stream][rate_limit]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0);
+
+        auto s = loop->make_stream(fds[0]);
+        loop->call_get([&] {
+            s->join(loop->make_rate_limit_group({.write_rate = 1024 * 1024, .write_burst = 64 * 1024}));
+            s->set_rate_limit({.write_rate = 512 * 1024, .write_burst = 64 * 1024});
+        });
+
+        // the group goes with the stream, while the bufferevent is only scheduled to be freed
+        loop->call_get([&] { s.reset(); });
+        REQUIRE(loop->call_get([] { return true; }));
+
+        // the socket was closed with the bufferevent
+        char buf[16];
+        REQUIRE(::read(fds[1], buf, sizeof(buf)) == 0);
+        ::close(fds[1]);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,276 @@
+#include "utils.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <expected>
+#include <future>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    namespace {
+        using lease_result = std::expected<test_loop::connection_pool::lease, std::error_code>;
+
+        // Listening loopback socket on an ephemeral port; the kernel completes handshakes without accept
+        struct listener {
+            int fd{-1};
+            uint16_t port{0};
+
+            explicit listener(int backlog = 64) {
+                fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                sockaddr_in sin{};
+                sin.sin_family = AF_INET;
+                sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                socklen_t len = sizeof(sin);
+                if (::bind(fd, reinterpret_cast<sockaddr*>(&sin), len) != 0 or ::listen(fd, backlog) != 0 or
+                    ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &len) != 0) {
+                    throw std::system_error{errno, std::system_category(), "listener"};
+                }
+                port = ntohs(sin.sin_port);
+            }
+
+            ~listener() { ::close(fd); }
+
+            // Accepts and closes every connection made so far, returning how many there were
+            int accepted() const {
+                int n{0};
+                for (int c; (c = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0; ++n) {
+                    ::close(c);
+                }
+                return n;
+            }
+        };
+
+        // Listener whose accept queue is full, so that further handshakes get no answer at all
+        struct stalled_listener : listener {
+            std::vector<int> fillers;
+
+            stalled_listener() : listener{0} {
+                sockaddr_in sin{};
+                sin.sin_family = AF_INET;
+                sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                sin.sin_port = htons(port);
+                for (int i = 0; i < 4; ++i) {
+                    auto c = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                    (void)::connect(c, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));
+                    fillers.push_back(c);
+                }
+                // let the handshakes that fit complete
+                std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            }
+
+            ~stalled_listener() {
+                for (auto c : fillers) {
+                    ::close(c);
+                }
+            }
+        };
+
+        // A port with nothing listening on it, so connects are refused
+        uint16_t closed_port() {
+            listener l;
+            return l.port;
+        }
+
+        std::future<lease_result> acquire(test_loop::connection_pool& pool, endpoint ep) {
+            auto p = std::make_shared<std::promise<lease_result>>();
+            auto f = p->get_future();
+            pool.acquire(std::move(ep), [p](lease_result r) { p->set_value(std::move(r)); });
+            return f;
+        }
+    }  // namespace
+
+    TEST_CASE("event_loop connection pool reuses released connections", "[event_loop][connection_pool]") {
+        auto loop = test_loop::make();
+        listener srv;
+        auto pool = loop->make_connection_pool();
+        endpoint ep{"127.0.0.1", srv.port};
+
+        auto first = acquire(*pool, ep).get();
+        REQUIRE(first);
+        auto* conn = &**first;
+        first->reset();
+
+        auto second = acquire(*pool, ep).get();
+        REQUIRE(second);
+        REQUIRE(&**second == conn);
+
+        auto st = pool->stats();
+        REQUIRE(st.connects == 1);
+        REQUIRE(st.reuses == 1);
+        REQUIRE(st.open == 1);
+        REQUIRE(srv.accepted() == 1);
+
+        // a discarded connection is closed, so the next acquire dials again
+        second->discard();
+        auto third = acquire(*pool, ep).get();
+        REQUIRE(third);
+        REQUIRE(pool->stats().connects == 2);
+
+        third->reset();
+        pool.reset();
+    }
+
+    TEST_CASE("event_loop connection pool caps connections per endpoint", "[event_loop][connection_pool]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        listener srv;
+        auto pool = loop->make_connection_pool({.max_per_endpoint = 1});
+        endpoint ep{"127.0.0.1", srv.port};
+
+        auto first = acquire(*pool, ep).get();
+        REQUIRE(first);
+
+        auto queued = acquire(*pool, ep);
+        REQUIRE(queued.wait_for(100ms) == std::future_status::timeout);
+        REQUIRE(pool->stats().waiting == 1);
+
+        // releasing hands the connection straight to the waiter
+        first->reset();
+        auto second = queued.get();
+        REQUIRE(second);
+
+        auto st = pool->stats();
+        REQUIRE(st.connects == 1);
+        REQUIRE(st.reuses == 1);
+        REQUIRE(st.waiting == 0);
+
+        second->reset();
+        pool.reset();
+    }
+
+    TEST_CASE("event_loop connection pool and its leases may outlive the loop", "[event_loop][connection_pool]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        listener srv;
+        auto pool = loop->make_connection_pool({.max_per_endpoint = 1});
+        endpoint ep{"127.0.0.1", srv.port};
+
+        auto first = acquire(*pool, ep).get();
+        REQUIRE(first);
+        auto queued = acquire(*pool, ep);
+        REQUIRE(queued.wait_for(100ms) == std::future_status::timeout);
+
+        loop.reset();
+
+        // the lease's connection is closed rather than handed back, and new acquires are refused
+        first->reset();
+        auto refused = acquire(*pool, ep).get();
+        REQUIRE_FALSE(refused);
+        REQUIRE(refused.error() == std::errc::operation_canceled);
+        REQUIRE(pool->stats().waiting == 1);
+
+        pool.reset();
+        auto dropped = queued.get();
+        REQUIRE_FALSE(dropped);
+        REQUIRE(dropped.error() == std::errc::operation_canceled);
+    }
+
+    TEST_CASE("event_loop connection pool sweeps idle connections", "[event_loop][connection_pool]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        listener srv;
+        auto ticker = loop->make_ticker_group(20ms);
+        auto pool = loop->make_connection_pool({.idle_timeout = 50ms}, ticker);
+        endpoint ep{"127.0.0.1", srv.port};
+
+        auto l = acquire(*pool, ep).get();
+        REQUIRE(l);
+        l->reset();
+        REQUIRE(pool->stats().idle == 1);
+
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (pool->stats().open > 0 and std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(10ms);
+        }
+        REQUIRE(pool->stats().open == 0);
+
+        // with nothing idle, the next acquire opens a fresh connection
+        auto again = acquire(*pool, ep).get();
+        REQUIRE(again);
+        REQUIRE(pool->stats().connects == 2);
+
+        again->reset();
+        pool.reset();
+    }
+
+    TEST_CASE("event_loop tcp_connect falls through refused addresses", "[event_loop][connection_pool]") {
+        auto loop = test_loop::make();
+        listener srv;
+        auto dead = closed_port();
+
+        auto addrs = numeric_addresses("127.0.0.1", dead);
+        auto good = numeric_addresses("127.0.0.1", srv.port);
+        REQUIRE(addrs.size() == 1);
+        REQUIRE(good.size() == 1);
+        addrs.push_back(good.front());
+
+        std::promise<std::error_code> done;
+        loop->call_get([&] {
+            (void)tcp_connect::start(loop->loop(), addrs, [&](std::error_code ec, evutil_socket_t fd) {
+                if (not ec) {
+                    ::close(fd);
+                }
+                done.set_value(ec);
+            });
+        });
+        REQUIRE_FALSE(done.get_future().get());
+        REQUIRE(srv.accepted() == 1);
+
+        // every address refused: the last failure is reported
+        std::promise<std::error_code> refused;
+        loop->call_get([&] {
+            (void)tcp_connect::start(
+                    loop->loop(), numeric_addresses("127.0.0.1", dead), [&](std::error_code ec, evutil_socket_t) {
+                        refused.set_value(ec);
+                    });
+        });
+        REQUIRE((refused.get_future().get() == std::errc::connection_refused));
+
+        REQUIRE(numeric_addresses("localhost.invalid", 80).empty());
+    }
+
+    TEST_CASE("event_loop tcp_connect races past an address that never answers", "[event_loop][connection_pool]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+        stalled_listener stalled;
+        listener srv;
+
+        auto addrs = numeric_addresses("127.0.0.1", stalled.port);
+        addrs.push_back(numeric_addresses("127.0.0.1", srv.port).front());
+
+        std::promise<std::error_code> done;
+        auto started = std::chrono::steady_clock::now();
+        loop->call_get([&] {
+            (void)tcp_connect::start(
+                    loop->loop(),
+                    addrs,
+                    [&](std::error_code ec, evutil_socket_t fd) {
+                        if (not ec) {
+                            ::close(fd);
+                        }
+                        done.set_value(ec);
+                    },
+                    {.attempt_delay = 100ms, .timeout = 5s});
+        });
+
+        auto fut = done.get_future();
+        REQUIRE(fut.wait_for(5s) == std::future_status::ready);
+        auto took = std::chrono::steady_clock::now() - started;
+        REQUIRE_FALSE(fut.get());
+        REQUIRE(srv.accepted() == 1);
+        // the second address started once the first had its head start, long before the timeout
+        REQUIRE(took >= 90ms);
+        REQUIRE(took < 1s);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,239 @@
+#include "utils.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace un::event::test {
+    namespace {
+        struct response {
+            int status{0};
+            std::string headers;
+            std::string body;
+        };
+
+        // Blocking HTTP/1.1 client on one loopback connection, just enough to read what evhttp sends
+        struct client {
+            int fd{-1};
+            std::string buf;
+
+            explicit client(uint16_t port) {
+                fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                timeval tv{.tv_sec = 5, .tv_usec = 0};
+                ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+                sockaddr_in sin{};
+                sin.sin_family = AF_INET;
+                sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                sin.sin_port = htons(port);
+                if (::connect(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) != 0) {
+                    throw std::system_error{errno, std::system_category(), "connect"};
+                }
+            }
+
+            ~client() { ::close(fd); }
+
+            void send(std::string_view data) const {
+                REQUIRE(::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+            }
+
+            // Blocks until at least `n` bytes are buffered
+            void fill(size_t n) {
+                char tmp[4096];
+                while (buf.size() < n) {
+                    auto r = ::read(fd, tmp, sizeof(tmp));
+                    REQUIRE(r > 0);
+                    buf.append(tmp, r);
+                }
+            }
+
+            std::string take(size_t n) {
+                fill(n);
+                auto out = buf.substr(0, n);
+                buf.erase(0, n);
+                return out;
+            }
+
+            std::string line() {
+                size_t pos;
+                while ((pos = buf.find("\r\n")) == std::string::npos) {
+                    fill(buf.size() + 1);
+                }
+                auto out = take(pos + 2);
+                out.resize(pos);
+                return out;
+            }
+
+            response read() {
+                response r;
+                auto status = line();
+                std::from_chars(status.data() + 9, status.data() + status.size(), r.status);
+
+                for (auto l = line(); not l.empty(); l = line()) {
+                    r.headers += l + "\n";
+                }
+
+                if (r.headers.find("Transfer-Encoding: chunked") != std::string::npos) {
+                    for (;;) {
+                        auto size = line();
+                        size_t n{0};
+                        std::from_chars(size.data(), size.data() + size.size(), n, 16);
+                        r.body += take(n);
+                        line();
+                        if (n == 0) {
+                            break;
+                        }
+                    }
+                }
+                else if (auto pos = r.headers.find("Content-Length: "); pos != std::string::npos) {
+                    size_t n{0};
+                    std::from_chars(r.headers.data() + pos + 16, r.headers.data() + r.headers.size(), n);
+                    r.body = take(n);
+                }
+                return r;
+            }
+
+            response get(std::string_view path, std::string_view method = "GET") {
+                send(std::string{method} + " " + std::string{path} +
+                     " HTTP/1.1\r\nHost: localhost\r\nContent-Length: 0\r\n\r\n");
+                return read();
+            }
+        };
+    }  // namespace
+
+    TEST_CASE("event_loop http server dispatches routes", "[event_loop][http]") {
+        auto loop = test_loop::make();
+
+        auto srv = loop->make_http_server({}, [](test_loop::http_server& s) {
+            s.route("/hello", [](http_request req) { req.reply(HTTP_OK, "hello"); }, {EVHTTP_REQ_GET});
+            s.route("/api/*", [](http_request req) {
+                req.add_header("Content-Type", "text/plain");
+                req.reply(HTTP_OK, std::string{req.path()} + "?" + std::string{req.query()});
+            });
+        });
+        REQUIRE(srv->port() != 0);
+
+        client c{srv->port()};
+
+        auto r = c.get("/hello");
+        REQUIRE(r.status == 200);
+        REQUIRE(r.body == "hello");
+
+        r = c.get("/api/v1/items?limit=3");
+        REQUIRE(r.status == 200);
+        REQUIRE(r.body == "/api/v1/items?limit=3");
+        REQUIRE(r.headers.find("Content-Type: text/plain") != std::string::npos);
+
+        REQUIRE(c.get("/nope").status == 404);
+        REQUIRE(c.get("/hello", "POST").status == 405);
+
+        // routes added later, from another thread, replace earlier ones for the methods they name
+        srv->route("/hello", [](http_request req) { req.reply(HTTP_OK, "created"); }, {EVHTTP_REQ_POST});
+        r = c.get("/hello", "POST");
+        REQUIRE(r.status == 200);
+        REQUIRE(r.body == "created");
+        REQUIRE(c.get("/hello").body == "hello");
+
+        srv.reset();
+    }
+
+    TEST_CASE("event_loop http server answers pipelined requests in order", "[event_loop][http]") {
+        using namespace std::chrono_literals;
+
+        auto loop = test_loop::make();
+
+        auto srv = loop->make_http_server({}, [&](test_loop::http_server& s) {
+            // answered later from a timer, while the requests behind it are already buffered
+            s.route("/slow", [&](http_request req) {
+                auto held = std::make_shared<http_request>(std::move(req));
+                loop->call_later(50ms, [held] { held->reply(HTTP_OK, "slow"); });
+            });
+            s.route("/fast", [](http_request req) { req.reply(HTTP_OK, "fast"); });
+        });
+
+        client c{srv->port()};
+        c.send("GET /slow HTTP/1.1\r\nHost: a\r\n\r\n"
+               "GET /fast HTTP/1.1\r\nHost: a\r\n\r\n"
+               "GET /slow HTTP/1.1\r\nHost: a\r\n\r\n"
+               "GET /fast HTTP/1.1\r\nHost: a\r\n\r\n");
+
+        REQUIRE(c.read().body == "slow");
+        REQUIRE(c.read().body == "fast");
+        REQUIRE(c.read().body == "slow");
+        REQUIRE(c.read().body == "fast");
+
+        // a handler that drops its request unanswered still produces a response
+        srv->route("/dropped", [](http_request) {});
+        REQUIRE(c.get("/dropped").status == 500);
+        REQUIRE(c.get("/fast").body == "fast");
+
+        srv.reset();
+    }
+
+    TEST_CASE("event_loop http server streams referenced chunks", "[event_loop][http]") {
+        auto loop = test_loop::make();
+
+        auto payload = std::make_shared<const std::string>(64 * 1024, 'x');
+        std::weak_ptr<const std::string> watch = payload;
+
+        auto srv = loop->make_http_server({}, [&](test_loop::http_server& s) {
+            s.route("/stream", [p = std::move(payload)](http_request req) mutable {
+                req.start(HTTP_OK);
+                req.chunk("head;");
+                req.chunk_ref(*p, p);
+                p.reset();
+
+                auto* buf = evbuffer_new();
+                evbuffer_add(buf, ";tail", 5);
+                req.chunk(buf);
+                evbuffer_free(buf);
+                req.end();
+            });
+            s.route("/static", [](http_request req) { req.reply_ref(HTTP_OK, "static body"); });
+        });
+
+        client c{srv->port()};
+
+        auto r = c.get("/stream");
+        REQUIRE(r.status == 200);
+        REQUIRE(r.body.size() == 5 + 64 * 1024 + 5);
+        REQUIRE(r.body.starts_with("head;xxxx"));
+        REQUIRE(r.body.ends_with("xxxx;tail"));
+
+        // the referenced payload is let go once it has been written out
+        REQUIRE(loop->call_get([&] { return watch.expired(); }));
+
+        REQUIRE(c.get("/static").body == "static body");
+
+        srv.reset();
+    }
+
+    TEST_CASE("loop_pool http servers share one port", "[event_loop][http][loop_pool]") {
+        loop_pool<test_channel> pool{3};
+
+        auto servers = pool.serve_http({}, [](test_loop::http_server& s) {
+            s.route("/ping", [](http_request req) { req.reply(HTTP_OK, "pong"); });
+        });
+        REQUIRE(servers.size() == 3);
+        for (auto& s : servers) {
+            REQUIRE(s->port() == servers.front()->port());
+        }
+
+        for (int i = 0; i < 16; ++i) {
+            client c{servers.front()->port()};
+            auto r = c.get("/ping");
+            REQUIRE(r.status == 200);
+            REQUIRE(r.body == "pong");
+        }
+
+        servers.clear();
+    }
+}  // namespace un::event::test
@@ -0,0 +1,427 @@
+#include "utils.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <expected>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    namespace {
+        /** Loopback UDP nameserver answering A queries from a table (NXDOMAIN for anything else) and
+            AAAA queries with an empty NOERROR; counts the A queries it sees per name. Names in
+            `servfail` get SERVFAIL for A and, a little later, NXDOMAIN for AAAA.
+         */
+        struct nameserver {
+            struct record {
+                std::string ipv4;
+                uint32_t ttl;
+            };
+
+            int fd{-1};
+            uint16_t port{0};
+            std::map<std::string, record> records;
+            std::set<std::string> servfail;
+            std::mutex mutex;
+            std::map<std::string, int> counts;
+            std::atomic<bool> stop{false};
+            std::thread thread;
+
+            explicit nameserver(std::map<std::string, record> r, std::set<std::string> failing = {}) :
+                    records{std::move(r)}, servfail{std::move(failing)} {
+                fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+                sockaddr_in sin{};
+                sin.sin_family = AF_INET;
+                sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                socklen_t len = sizeof(sin);
+                if (::bind(fd, reinterpret_cast<sockaddr*>(&sin), len) != 0 or
+                    ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &len) != 0) {
+                    throw std::system_error{errno, std::system_category(), "nameserver"};
+                }
+                port = ntohs(sin.sin_port);
+                thread = std::thread{[this] { run(); }};
+            }
+
+            ~nameserver() {
+                stop = true;
+                thread.join();
+                ::close(fd);
+            }
+
+            std::string address() const { return "127.0.0.1:" + std::to_string(port); }
+
+            int queries(const std::string& name) {
+                std::lock_guard lock{mutex};
+                return counts[name];
+            }
+
+            void run() {
+                struct reply {
+                    std::chrono::steady_clock::time_point due;
+                    std::string data;
+                    sockaddr_storage to;
+                    socklen_t len;
+                };
+                std::vector<reply> delayed;
+
+                unsigned char buf[512];
+                while (not stop) {
+                    std::erase_if(delayed, [&](const reply& r) {
+                        if (r.due > std::chrono::steady_clock::now()) {
+                            return false;
+                        }
+                        ::sendto(fd, r.data.data(), r.data.size(), 0, reinterpret_cast<const sockaddr*>(&r.to), r.len);
+                        return true;
+                    });
+
+                    pollfd p{fd, POLLIN, 0};
+                    if (::poll(&p, 1, 5) <= 0) {
+                        continue;
+                    }
+
+                    sockaddr_storage from{};
+                    socklen_t flen = sizeof(from);
+                    auto n = ::recvfrom(fd, buf, sizeof(buf), 0, reinterpret_cast<sockaddr*>(&from), &flen);
+                    if (n < 12) {
+                        continue;
+                    }
+
+                    // question name, lowercased (evdns randomizes its case)
+                    std::string name;
+                    size_t pos = 12;
+                    while (pos < static_cast<size_t>(n) and buf[pos] != 0) {
+                        if (not name.empty()) {
+                            name += '.';
+                        }
+                        for (int i = 1; i <= buf[pos]; ++i) {
+                            name += static_cast<char>(std::tolower(buf[pos + i]));
+                        }
+                        pos += buf[pos] + 1;
+                    }
+                    pos += 1;
+                    uint16_t qtype = (buf[pos] << 8) | buf[pos + 1];
+                    size_t qend = pos + 4;
+
+                    std::string out(reinterpret_cast<char*>(buf), qend);
+                    out[2] = static_cast<char>(0x81);  // response, recursion desired
+                    out[3] = static_cast<char>(0x80);  // recursion available, NOERROR
+                    out[6] = out[7] = out[8] = out[9] = out[10] = out[11] = 0;
+
+                    auto it = records.find(name);
+                    if (qtype == DNS_IPv4_A) {
+                        std::lock_guard lock{mutex};
+                        ++counts[name];
+                    }
+
+                    if (servfail.contains(name)) {
+                        if (qtype == DNS_IPv4_A) {
+                            out[3] = static_cast<char>(0x82);  // SERVFAIL
+                        }
+                        else {
+                            // lands after the A failure has been delivered
+                            out[3] = static_cast<char>(0x83);
+                            delayed.push_back({std::chrono::steady_clock::now() + 50ms, out, from, flen});
+                            continue;
+                        }
+                    }
+                    else if (it == records.end()) {
+                        out[3] = static_cast<char>(0x83);  // NXDOMAIN
+                    }
+                    else if (qtype == DNS_IPv4_A) {
+                        out[7] = 1;
+                        in_addr a{};
+                        ::inet_pton(AF_INET, it->second.ipv4.c_str(), &a);
+                        unsigned char rr[16] = {0xc0, 0x0c, 0, 1, 0, 1};
+                        rr[6] = it->second.ttl >> 24;
+                        rr[7] = it->second.ttl >> 16;
+                        rr[8] = it->second.ttl >> 8;
+                        rr[9] = it->second.ttl;
+                        rr[11] = 4;
+                        std::memcpy(rr + 12, &a, 4);
+                        out.append(reinterpret_cast<char*>(rr), sizeof(rr));
+                    }
+
+                    ::sendto(fd, out.data(), out.size(), 0, reinterpret_cast<sockaddr*>(&from), flen);
+                }
+            }
+        };
+
+        // Temporary hosts file, removed on destruction
+        struct hosts_file {
+            std::string path;
+
+            explicit hosts_file(const std::string& contents) {
+                char tmpl[] = "/tmp/uneventful-hosts-XXXXXX";
+                int fd = ::mkstemp(tmpl);
+                ::close(fd);
+                path = tmpl;
+                std::ofstream{path} << contents;
+            }
+
+            ~hosts_file() { std::remove(path.c_str()); }
+        };
+
+        dns_result resolve(test_loop::dns_resolver& r, std::string host, uint16_t port = 0) {
+            auto p = std::make_shared<std::promise<dns_result>>();
+            auto f = p->get_future();
+            r.resolve(std::move(host), port, [p](dns_result res) { p->set_value(std::move(res)); });
+            return f.get();
+        }
+
+        std::string ipv4_of(const sock_address& a) {
+            const auto* sin = reinterpret_cast<const sockaddr_in*>(&a.addr);
+            char buf[INET_ADDRSTRLEN];
+            ::inet_ntop(AF_INET, &sin->sin_addr, buf, sizeof(buf));
+            return std::string{buf} + ":" + std::to_string(ntohs(sin->sin_port));
+        }
+
+        dns_options options_for(const nameserver& ns, std::string hosts = "") {
+            dns_options opts;
+            opts.nameservers = {ns.address()};
+            opts.hosts_file = std::move(hosts);
+            opts.timeout = 1s;
+            return opts;
+        }
+    }  // namespace
+
+    TEST_CASE("event_loop dns resolver answers locally known names without a query", "[event_loop][dns]") {
+        nameserver ns{{}};
+        hosts_file hosts{"# comment\n10.1.2.3  pinned.test pinned-alias.test\n::1 six.test\n"};
+
+        auto loop = test_loop::make();
+        auto r = loop->make_resolver(options_for(ns, hosts.path));
+
+        auto res = resolve(*r, "Pinned.Test.", 80);
+        REQUIRE(res);
+        REQUIRE(res->size() == 1);
+        REQUIRE(ipv4_of(res->front()) == "10.1.2.3:80");
+
+        res = resolve(*r, "pinned-alias.test", 81);
+        REQUIRE(res);
+        REQUIRE(ipv4_of(res->front()) == "10.1.2.3:81");
+
+        res = resolve(*r, "six.test");
+        REQUIRE(res);
+        REQUIRE(res->front().family() == AF_INET6);
+
+        res = resolve(*r, "192.168.0.1", 443);
+        REQUIRE(res);
+        REQUIRE(ipv4_of(res->front()) == "192.168.0.1:443");
+
+        REQUIRE(ns.queries("pinned.test") == 0);
+        REQUIRE(r->shared_cache()->stats().misses == 0);
+
+        r.reset();
+    }
+
+    TEST_CASE("event_loop dns resolver caches answers for their TTL", "[event_loop][dns]") {
+        nameserver ns{{{"cached.test", {"10.0.0.1", 300}}, {"fresh.test", {"10.0.0.2", 0}}}};
+
+        auto loop = test_loop::make();
+        auto r = loop->make_resolver(options_for(ns));
+
+        auto res = resolve(*r, "cached.test", 1000);
+        REQUIRE(res);
+        REQUIRE(res->size() == 1);
+        REQUIRE(ipv4_of(res->front()) == "10.0.0.1:1000");
+
+        // the cached addresses take the port of each lookup
+        res = resolve(*r, "CACHED.test", 2000);
+        REQUIRE(res);
+        REQUIRE(ipv4_of(res->front()) == "10.0.0.1:2000");
+        REQUIRE(ns.queries("cached.test") == 1);
+
+        // a zero TTL is not cached at all
+        REQUIRE(resolve(*r, "fresh.test"));
+        REQUIRE(resolve(*r, "fresh.test"));
+        REQUIRE(ns.queries("fresh.test") == 2);
+
+        auto st = r->shared_cache()->stats();
+        REQUIRE(st.hits == 1);
+        REQUIRE(st.entries == 1);
+
+        r.reset();
+    }
+
+    TEST_CASE("event_loop dns resolver caches names that do not exist", "[event_loop][dns]") {
+        nameserver ns{{}};
+
+        auto loop = test_loop::make();
+        auto r = loop->make_resolver(options_for(ns));
+
+        auto res = resolve(*r, "missing.test");
+        REQUIRE_FALSE(res);
+        REQUIRE(res.error() == make_dns_error(DNS_ERR_NOTEXIST));
+
+        res = resolve(*r, "missing.test");
+        REQUIRE_FALSE(res);
+        REQUIRE(res.error() == make_dns_error(DNS_ERR_NOTEXIST));
+
+        REQUIRE(ns.queries("missing.test") == 1);
+        REQUIRE(r->shared_cache()->stats().negative_hits == 1);
+
+        r.reset();
+    }
+
+    TEST_CASE("event_loop dns resolver keeps a failed family from being cached as missing", "[event_loop][dns]") {
+        nameserver ns{{}, {"flaky.test"}};
+
+        auto loop = test_loop::make();
+        auto opts = options_for(ns);
+        // SERVFAIL counts as a timeout; with one attempt it fails the A query at once
+        opts.attempts = 1;
+        auto r = loop->make_resolver(opts);
+
+        // A fails first, then AAAA reports NXDOMAIN: the name may well exist, so nothing is cached
+        auto res = resolve(*r, "flaky.test");
+        REQUIRE_FALSE(res);
+        REQUIRE(res.error() == make_dns_error(DNS_ERR_TIMEOUT));
+
+        res = resolve(*r, "flaky.test");
+        REQUIRE_FALSE(res);
+        REQUIRE(res.error() == make_dns_error(DNS_ERR_TIMEOUT));
+        REQUIRE(ns.queries("flaky.test") == 2);
+        REQUIRE(r->shared_cache()->stats().negative_hits == 0);
+
+        r.reset();
+    }
+
+    TEST_CASE("event_loop dns resolver may outlive its loop", "[event_loop][dns]") {
+        // a nameserver that never answers, so the query is still outstanding when the loop goes
+        int silent = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        sockaddr_in sin{};
+        sin.sin_family = AF_INET;
+        sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(sin);
+        REQUIRE(::bind(silent, reinterpret_cast<sockaddr*>(&sin), len) == 0);
+        REQUIRE(::getsockname(silent, reinterpret_cast<sockaddr*>(&sin), &len) == 0);
+
+        dns_options opts;
+        opts.nameservers = {"127.0.0.1:" + std::to_string(ntohs(sin.sin_port))};
+        opts.timeout = 10s;
+
+        auto loop = test_loop::make();
+        auto r = loop->make_resolver(opts);
+
+        auto p = std::make_shared<std::promise<dns_result>>();
+        auto pending = p->get_future();
+        loop->call_get([&] { r->resolve("silent.test", 0, [p](dns_result res) { p->set_value(std::move(res)); }); });
+
+        loop.reset();
+
+        auto refused = resolve(*r, "late.test");
+        REQUIRE_FALSE(refused);
+        REQUIRE(refused.error() == std::errc::operation_canceled);
+
+        r.reset();
+        REQUIRE(pending.wait_for(0s) == std::future_status::ready);
+        REQUIRE(pending.get().error() == std::errc::operation_canceled);
+        ::close(silent);
+    }
+
+    TEST_CASE("event_loop dns resolver coalesces concurrent lookups of a name", "[event_loop][dns]") {
+        nameserver ns{{{"busy.test", {"10.0.0.3", 0}}}};
+
+        auto loop = test_loop::make();
+        auto r = loop->make_resolver(options_for(ns));
+
+        std::vector<std::future<dns_result>> results;
+        loop->call_get([&] {
+            for (uint16_t port = 1; port <= 3; ++port) {
+                auto p = std::make_shared<std::promise<dns_result>>();
+                results.push_back(p->get_future());
+                r->resolve("busy.test", port, [p](dns_result res) { p->set_value(std::move(res)); });
+            }
+        });
+
+        for (uint16_t port = 1; port <= 3; ++port) {
+            auto res = results[port - 1].get();
+            REQUIRE(res);
+            REQUIRE(ipv4_of(res->front()) == "10.0.0.3:" + std::to_string(port));
+        }
+        REQUIRE(ns.queries("busy.test") == 1);
+
+        r.reset();
+    }
+
+    TEST_CASE("loop_pool dns resolvers share one cache", "[event_loop][dns][loop_pool]") {
+        nameserver ns{{{"shared.test", {"10.0.0.4", 300}}}};
+
+        loop_pool<test_channel> pool{3};
+        auto resolvers = pool.make_resolvers(options_for(ns));
+        REQUIRE(resolvers.size() == 3);
+
+        for (auto& r : resolvers) {
+            REQUIRE(r->shared_cache() == resolvers.front()->shared_cache());
+            auto res = resolve(*r, "shared.test", 53);
+            REQUIRE(res);
+            REQUIRE(ipv4_of(res->front()) == "10.0.0.4:53");
+        }
+        REQUIRE(ns.queries("shared.test") == 1);
+
+        resolvers.clear();
+    }
+
+    TEST_CASE("event_loop connection pool connects through a dns resolver", "[event_loop][dns][connection_pool]") {
+        nameserver ns{{{"svc.test", {"127.0.0.1", 300}}}};
+
+        int lfd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in sin{};
+        sin.sin_family = AF_INET;
+        sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(sin);
+        REQUIRE(::bind(lfd, reinterpret_cast<sockaddr*>(&sin), len) == 0);
+        REQUIRE(::listen(lfd, 16) == 0);
+        REQUIRE(::getsockname(lfd, reinterpret_cast<sockaddr*>(&sin), &len) == 0);
+
+        auto loop = test_loop::make();
+        auto r = loop->make_resolver(options_for(ns));
+        auto pool = loop->make_connection_pool({}, nullptr, r);
+
+        using lease_result = std::expected<test_loop::connection_pool::lease, std::error_code>;
+        auto acquire = [&](std::string host) {
+            auto p = std::make_shared<std::promise<lease_result>>();
+            auto f = p->get_future();
+            pool->acquire({std::move(host), ntohs(sin.sin_port)}, [p](lease_result res) {
+                p->set_value(std::move(res));
+            });
+            return f.get();
+        };
+
+        auto first = acquire("svc.test");
+        REQUIRE(first);
+        auto second = acquire("svc.test");
+        REQUIRE(second);
+        REQUIRE(pool->stats().connects == 2);
+        REQUIRE(ns.queries("svc.test") == 1);
+
+        auto missing = acquire("nowhere.test");
+        REQUIRE_FALSE(missing);
+        REQUIRE(missing.error() == make_dns_error(DNS_ERR_NOTEXIST));
+
+        first->reset();
+        second->reset();
+        pool.reset();
+        r.reset();
+        ::close(lfd);
+    }
+}  // namespace un::event::test
@@ -0,0 +1,272 @@
+#include "utils.hpp"
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace un::event::test {
+    namespace {
+        // Message `i` of a test stream: its index, padded to a length that varies with it
+        std::string message(int i) {
+            auto s = std::to_string(i);
+            s.resize(s.size() + (i * 37) % 300, static_cast<char>('a' + i % 26));
+            return s;
+        }
+
+        // Both ends of a channel in this process, the second mapped through SCM_RIGHTS like a peer's
+        std::pair<shm_channel, shm_channel> channel_pair(size_t capacity) {
+            int sv[2];
+            REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == 0);
+            auto a = shm_channel::create(capacity);
+            a.send_to(sv[0]);
+            auto b = shm_channel::receive(sv[1]);
+            ::close(sv[0]);
+            ::close(sv[1]);
+            return {std::move(a), std::move(b)};
+        }
+    }  // namespace
+
+    TEST_CASE("shm channel carries messages from another process", "[event_loop][shm]") {
+        constexpr int count = 20'000;
+
+        int sv[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == 0);
+
+        // earlier cases may have left threads running here, so the child keeps to the channel and plain
+        // allocations, which glibc keeps usable in the child of a multithreaded fork
+        pid_t pid = ::fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0) {
+            ::close(sv[0]);
+            int rc{0};
+            try {
+                auto ch = shm_channel::receive(sv[1]);
+                for (int i = 0; i < count; ++i) {
+                    while (not ch.try_send(message(i))) {
+                        ::sched_yield();
+                    }
+                }
+            } catch (...) {
+                rc = 1;
+            }
+            ::_exit(rc);
+        }
+        ::close(sv[1]);
+
+        // small enough for the writer to wrap around and wait on the reader many times over
+        auto ch = shm_channel::create(16 << 10);
+        ch.send_to(sv[0]);
+        ::close(sv[0]);
+
+        auto loop = test_loop::make();
+        std::promise<void> done;
+        int received{0};
+        bool in_order{true};
+
+        auto reader = loop->make_shm_reader(std::move(ch), [&](std::string_view msg) {
+            in_order = in_order and msg == message(received);
+            if (++received == count) {
+                done.set_value();
+            }
+        });
+
+        int status{0};
+        REQUIRE(::waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+
+        REQUIRE(done.get_future().wait_for(10s) == std::future_status::ready);
+        REQUIRE(in_order);
+        REQUIRE(loop->call_get([&] { return reader->messages(); }) == count);
+
+        reader.reset();
+    }
+
+    TEST_CASE("shm channel wakes the reader once per published batch", "[event_loop][shm]") {
+        auto [writer, ch] = channel_pair(64 << 10);
+
+        auto loop = test_loop::make();
+        std::vector<std::string> got;
+        auto reader = loop->make_shm_reader(std::move(ch), [&](std::string_view msg) { got.emplace_back(msg); });
+
+        auto delivered = [&](size_t n) {
+            while (loop->call_get([&] { return got.size(); }) < n) {
+                std::this_thread::sleep_for(1ms);
+            }
+        };
+
+        // the reader is asleep from the start, so the first publish wakes it...
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(writer.try_write(message(i)));
+        }
+        writer.publish();
+        delivered(100);
+        REQUIRE(writer.notifications() == 1);
+
+        // ...and once it has gone back to sleep, each lone publish wakes it again
+        REQUIRE(writer.try_send("one"));
+        delivered(101);
+        REQUIRE(writer.try_send("two"));
+        delivered(102);
+        REQUIRE(writer.notifications() == 3);
+
+        // publishing nothing is free
+        writer.publish();
+        REQUIRE(writer.notifications() == 3);
+
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(got[i] == message(i));
+        }
+        REQUIRE(got[100] == "one");
+        REQUIRE(got[101] == "two");
+        REQUIRE(loop->call_get([&] { return reader->wakeups(); }) <= 4);
+
+        reader.reset();
+    }
+
+    TEST_CASE("shm channel reserves space in place and refuses what does not fit", "[shm]") {
+        auto [writer, reader] = channel_pair(4096);
+        REQUIRE(writer.capacity() == 4096);
+        REQUIRE(reader.capacity() == 4096);
+
+        REQUIRE_THROWS_AS(writer.reserve(writer.max_message() + 1), std::length_error);
+        REQUIRE_THROWS_AS(writer.commit(0), std::logic_error);
+
+        // written straight into the ring, and cut down to what was used
+        auto buf = writer.reserve(100);
+        REQUIRE(buf.size() == 100);
+        std::memcpy(buf.data(), "in place", 8);
+        writer.commit(8);
+
+        // staged messages stay invisible until published
+        std::vector<std::string> got;
+        auto collect = [&](std::string_view msg) { got.emplace_back(msg); };
+        REQUIRE(reader.read(collect) == 0);
+        writer.publish();
+        REQUIRE(reader.read(collect) == 1);
+        REQUIRE(got.back() == "in place");
+
+        // fill the ring until it pushes back, then drain part of it and go round the end
+        std::string big(1000, 'x');
+        int written{0};
+        while (writer.try_send(big)) {
+            ++written;
+        }
+        REQUIRE(written == 4);
+        REQUIRE_FALSE(writer.try_send(big));
+
+        REQUIRE(reader.read(collect, 2) == 2);
+        REQUIRE(writer.try_send(big));
+        REQUIRE(writer.try_send("tail"));
+
+        REQUIRE(reader.read(collect) == 4);
+        REQUIRE(got.size() == 7);
+        REQUIRE(got.back() == "tail");
+        REQUIRE(reader.arm());
+    }
+
+    TEST_CASE("shm channel refuses records that reach outside the ring", "[shm]") {
+        auto [writer, reader] = channel_pair(4096);
+
+        auto map_size = detail::shm_data_offset + 4096;
+        void* p = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, writer.native(), 0);
+        REQUIRE(p != MAP_FAILED);
+        auto* hdr = static_cast<detail::shm_header*>(p);
+        auto* ring = static_cast<std::byte*>(p) + detail::shm_data_offset;
+
+        int calls{0};
+        auto count = [&](std::string_view) { ++calls; };
+        auto forge = [&](uint64_t tail, uint64_t head, uint64_t pos, uint32_t len) {
+            std::memcpy(ring + pos, &len, sizeof(len));
+            hdr->tail.store(tail);
+            hdr->head.store(head);
+        };
+
+        // more published than the ring holds
+        forge(0, 4096 + 8, 0, 8);
+        REQUIRE_THROWS_AS(reader.read(count), std::runtime_error);
+
+        // a record that would run off the end of the mapping
+        forge(4088, 4088 + 112, 4088, 100);
+        REQUIRE_THROWS_AS(reader.read(count), std::runtime_error);
+
+        // a wrap marker jumping past what was published
+        forge(0, 8, 0, UINT32_MAX);
+        REQUIRE_THROWS_AS(reader.read(count), std::runtime_error);
+
+        // positions off the record grid
+        forge(4, 12, 4, 0);
+        REQUIRE_THROWS_AS(reader.read(count), std::runtime_error);
+
+        REQUIRE(calls == 0);
+        ::munmap(p, map_size);
+    }
+
+    TEST_CASE("shm reader may outlive its loop", "[event_loop][shm]") {
+        auto [writer, ch] = channel_pair(4096);
+
+        auto loop = test_loop::make();
+        int got{0};
+        auto reader = loop->make_shm_reader(std::move(ch), [&](std::string_view) { ++got; });
+
+        REQUIRE(writer.try_send("before"));
+        while (loop->call_get([&] { return got; }) < 1) {
+            std::this_thread::sleep_for(1ms);
+        }
+        loop.reset();
+
+        // nothing reads any more, but the ring and its descriptors stay valid until the reader goes
+        REQUIRE(writer.try_send("after"));
+        REQUIRE(reader->messages() == 1);
+        REQUIRE(reader->native().capacity() == 4096);
+        reader.reset();
+        REQUIRE(got == 1);
+    }
+
+    TEST_CASE("shm reader stops on a ring its peer has corrupted", "[event_loop][shm]") {
+        auto [writer, ch] = channel_pair(4096);
+
+        auto loop = test_loop::make();
+        std::vector<std::string> got;
+        auto reader = loop->make_shm_reader(std::move(ch), [&](std::string_view msg) { got.emplace_back(msg); });
+
+        REQUIRE(writer.try_send("ok"));
+        while (loop->call_get([&] { return got.size(); }) < 1) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        // the peer rewrites the header's capacity and the length of a record behind the channel's back
+        auto map_size = detail::shm_data_offset + 4096;
+        void* p = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, writer.native(), 0);
+        REQUIRE(p != MAP_FAILED);
+        static_cast<detail::shm_header*>(p)->capacity = 1 << 20;
+        REQUIRE(writer.try_write("bad"));
+        uint32_t len{100'000};
+        std::memcpy(static_cast<std::byte*>(p) + detail::shm_data_offset + 8, &len, sizeof(len));
+        writer.publish();
+
+        std::this_thread::sleep_for(50ms);
+        REQUIRE(writer.try_send("after"));
+        std::this_thread::sleep_for(50ms);
+
+        REQUIRE(loop->call_get([&] { return got.size(); }) == 1);
+        REQUIRE(loop->call_get([&] { return reader->native().capacity(); }) == 4096);
+        REQUIRE(writer.max_message() == 4096 / 2 - 8);
+
+        ::munmap(p, map_size);
+        reader.reset();
+    }
+}  // namespace un::event::test
@@ -0,0 +1,227 @@
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace un::event::test {
+    namespace {
+        std::shared_ptr<test_loop> make_virtual(const std::shared_ptr<manual_clock>& clock) {
+            loop_options opts{};
+            opts.clock = clock;
+            return test_loop::make(std::move(opts));
+        }
+    }  // namespace
+
+    TEST_CASE("event_loop manual clock fires call_later in deadline order", "[event_loop][clock][call_later]") {
+        auto clock = std::make_shared<manual_clock>();
+        auto loop = make_virtual(clock);
+        const auto t0 = clock->now();
+
+        std::vector<std::pair<int, std::chrono::steady_clock::duration>> fired;
+        auto record = [&](int id) { return [&, id] { fired.emplace_back(id, loop->now() - t0); }; };
+
+        loop->call_get([&] {
+            loop->call_later(30ms, record(3));
+            loop->call_later(10ms, record(1));
+            loop->call_later(20ms, record(2));
+            loop->call_later(20ms, record(22));
+        });
+        // scheduled from another thread, against the clock's time when called
+        REQUIRE(loop->call_later(50ms, record(5)));
+        REQUIRE(loop->now() == t0);
+
+        // nothing fires on its own, however long we wait
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(loop->call_get([&] { return fired.size(); }) == 0);
+
+        clock->advance(25ms);
+        REQUIRE(loop->call_get([&] { return fired.size(); }) == 3);
+        REQUIRE(clock->now() == t0 + 25ms);
+
+        clock->advance(1h);
+        loop->call_get([] {});
+
+        std::vector<std::pair<int, std::chrono::steady_clock::duration>> expected{
+                {1, 10ms}, {2, 20ms}, {22, 20ms}, {3, 30ms}, {5, 50ms}};
+        REQUIRE(fired == expected);
+    }
+
+    TEST_CASE("event_loop manual clock runs tickers on exact cadence", "[event_loop][clock][call_every]") {
+        auto clock = std::make_shared<manual_clock>();
+        auto loop = make_virtual(clock);
+        const auto t0 = clock->now();
+
+        std::vector<std::chrono::steady_clock::duration> ticks;
+        auto every = loop->call_every(100ms, [&] { ticks.push_back(loop->now() - t0); });
+
+        int fixed{0};
+        uint64_t late{0};
+        auto fixed_rate = loop->call_every_fixed(
+                250ms,
+                [&](uint64_t missed) {
+                    ++fixed;
+                    late += missed;
+                },
+                tick_policy::catch_up);
+
+        int grouped{0};
+        auto group = loop->make_ticker_group(200ms);
+        auto m1 = group->join([&] { ++grouped; });
+        auto m2 = group->join([&] { ++grouped; });
+
+        clock->advance(1s);
+        loop->call_get([&] {
+            REQUIRE(ticks.size() == 10);
+            for (size_t i = 0; i < ticks.size(); ++i) {
+                REQUIRE(ticks[i] == (i + 1) * 100ms);
+            }
+            // one jump covers every deadline, each of which is on time
+            REQUIRE(fixed == 4);
+            REQUIRE(late == 0);
+            REQUIRE(grouped == 10);
+        });
+
+        // a stopped ticker stays silent
+        loop->call_get([&] { every->stop(); });
+        clock->advance(1s);
+        loop->call_get([&] {
+            REQUIRE(ticks.size() == 10);
+            REQUIRE(fixed == 8);
+        });
+
+        m1.reset();
+        m2.reset();
+        group.reset();
+        every.reset();
+        fixed_rate.reset();
+    }
+
+    TEST_CASE("event_loop manual clock fires timers scheduled during an advance", "[event_loop][clock]") {
+        auto clock = std::make_shared<manual_clock>();
+        auto loop = make_virtual(clock);
+
+        int hops{0};
+        std::function<void()> hop = [&] {
+            if (++hops < 100) {
+                loop->call_later(10ms, hop);
+            }
+        };
+        loop->call_get([&] { loop->call_later(10ms, hop); });
+
+        clock->advance(505ms);
+        REQUIRE(loop->call_get([&] { return hops; }) == 50);
+
+        // due now: fires on the next advance, even an empty one
+        loop->call_get([&] { loop->call_later(0ms, [&] { hops = -1; }); });
+        clock->advance(0ms);
+        REQUIRE(loop->call_get([&] { return hops; }) == -1);
+
+        bool rejected{false};
+        loop->call_get([&] {
+            loop->call_later(1ms, [&] {
+                try {
+                    clock->advance(1ms);
+                } catch (const std::logic_error&) {
+                    rejected = true;
+                }
+            });
+        });
+        clock->advance(1ms);
+        REQUIRE(loop->call_get([&] { return rejected; }));
+
+        // one clock drives one loop
+        REQUIRE_THROWS_AS(make_virtual(clock), std::logic_error);
+    }
+
+    TEST_CASE("event_loop manual clock runs a million timers without waiting", "[event_loop][clock]") {
+        constexpr int count = 1'000'000;
+
+        auto clock = std::make_shared<manual_clock>();
+        auto loop = make_virtual(clock);
+        const auto t0 = clock->now();
+
+        int fired{0};
+        bool ordered{true};
+        auto last = t0;
+
+        loop->call_get([&] {
+            for (int i = 0; i < count; ++i) {
+                // spread over an hour, out of order
+                auto delay = std::chrono::microseconds{(static_cast<int64_t>(i) * 7919) % 3'600'000'000};
+                loop->call_later(delay, [&] {
+                    auto now = loop->now();
+                    ordered = ordered and now >= last;
+                    last = now;
+                    ++fired;
+                });
+            }
+        });
+
+        clock->advance(30min);
+        auto half = loop->call_get([&] { return fired; });
+        REQUIRE(half > 0);
+        REQUIRE(half < count);
+
+        clock->advance(30min);
+        loop->call_get([&] {
+            REQUIRE(fired == count);
+            REQUIRE(ordered);
+        });
+    }
+
+    TEST_CASE("event_loop manual clock tickers start and stop from any thread", "[event_loop][clock][call_every]") {
+        auto clock = std::make_shared<manual_clock>();
+        auto loop = make_virtual(clock);
+
+        std::atomic<int> ticks{0};
+        auto every = loop->call_every(1ms, [&] { ++ticks; });
+
+        std::atomic<bool> done{false};
+        std::thread advancer{[&] {
+            while (not done.load()) {
+                clock->advance(1ms);
+            }
+        }};
+
+        // off the loop thread, while it fires them
+        for (int i = 0; i < 1000; ++i) {
+            every->stop();
+            auto other = loop->call_every(1ms, [&] { ++ticks; });
+            every->start();
+        }
+        done.store(true);
+        advancer.join();
+        REQUIRE(ticks.load() > 0);
+
+        // stopped tickers stay silent
+        every->stop();
+        auto before = loop->call_get([&] { return ticks.load(); });
+        clock->advance(1s);
+        REQUIRE(loop->call_get([&] { return ticks.load(); }) == before);
+
+        // and may outlive their loop
+        every->start();
+        loop.reset();
+        every.reset();
+    }
+
+    TEST_CASE("event_loop manual clock timers are dropped by a draining shutdown", "[event_loop][clock][lifecycle]") {
+        auto clock = std::make_shared<manual_clock>();
+        auto loop = make_virtual(clock);
+
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(loop->call_later(1s, [] {}));
+        }
+        loop->call_get([] {});
+
+        // nothing would advance the clock, so they are not waited for
+        auto report = loop->shutdown(5s);
+        REQUIRE_FALSE(report.timed_out);
+        REQUIRE(report.timers_dropped == 5);
+    }
+}  // namespace un::event::test